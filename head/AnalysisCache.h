@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Image.h"
+#include "AnalysisResult.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est un cache de résultats d'analyses, indexé par l'empreinte du contenu
+/// des images (Image::hash).
+///
+/// Les résultats sont gardés en mémoire dans la limite de capacity entrées, les moins
+/// récemment utilisés étant retirés en premier. Si un dossier est donné, chaque
+/// résultat calculé y est aussi enregistré et peut être relu par une exécution suivante.
+///
+/// Voici un exemple :
+///
+/// AnalysisCache cache(16, "cache");
+/// Image img = Image::readAIP("images/amazonie_0");
+/// shared_ptr <const AnalysisResult> r = cache.analyse(img); // Calcul.
+/// r = cache.analyse(img);                                   // Immédiat.
+///
+/// Le cache peut être partagé entre plusieurs fils d'exécution.
+////////////////////////////////////////////////////////////////////////////////
+class AnalysisCache {
+
+public:
+
+  /// Crée un cache d'au plus capacity résultats en mémoire. Si directory n'est pas vide,
+  /// les résultats sont aussi lus et écrits dans ce dossier, qui doit exister.
+  /// Les zones sont formées selon le voisinage connectivity (4 ou 8, voir Analyst);
+  /// des caches de voisinages différents peuvent partager le même dossier.
+  AnalysisCache(size_t capacity, const string& directory = "", int connectivity = 4);
+
+  /// Interdit la copie de caches.
+  AnalysisCache(const AnalysisCache&) = delete;
+
+  /// Interdit l'affectation de caches.
+  AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+  /// Retourne le résultat de l'analyse de img : depuis la mémoire, depuis le dossier
+  /// du cache, ou à défaut en analysant img. Un résultat n'est réutilisé que pour une image
+  /// de mêmes dimensions et de même seconde empreinte, indépendante de Image::hash.
+  /// L'enregistrement dans le dossier est facultatif : s'il échoue (dossier en lecture
+  /// seule, disque plein), le résultat est quand même retourné.
+  shared_ptr <const AnalysisResult> analyse(const Image& img);
+
+  /// Retourne le nombre de résultats gardés en mémoire.
+  size_t size() const;
+
+  /// Retourne le nombre de demandes satisfaites sans analyse (mémoire ou dossier).
+  size_t nbHits() const;
+
+  /// Retourne le nombre de demandes ayant nécessité une analyse.
+  size_t nbMisses() const;
+
+  /// Vide la mémoire du cache, sans toucher au dossier.
+  void clear();
+
+private:
+
+  // Ce qui identifie une image : son empreinte (la clé de l'index), une seconde empreinte
+  // calculée autrement et ses dimensions, comparées à chaque résultat trouvé.
+  struct Key {
+
+    uint64_t hash;
+    uint64_t check;
+    int width, height;
+
+    bool operator==(const Key& k) const;
+  };
+
+  typedef pair <Key, shared_ptr <const AnalysisResult>> Entry;
+
+  // Nombre maximal de résultats en mémoire.
+  size_t capacity;
+
+  // Dossier d'enregistrement des résultats, vide s'il n'y en a pas.
+  string directory;
+
+  // Voisinage des analyses.
+  int connectivity;
+
+  // Les résultats en mémoire, du plus récemment utilisé au plus ancien.
+  list <Entry> entries;
+
+  // Position de chaque résultat dans entries selon l'empreinte de son image.
+  unordered_map <uint64_t, list <Entry>::iterator> index;
+
+  size_t hits, misses;
+
+  // Protège l'ensemble des membres ci-dessus.
+  mutable mutex lock;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Retourne la clé de img.
+  static Key keyOf(const Image& img);
+
+  // Retourne le résultat en mémoire de clé key et le marque comme récent, ou nullptr.
+  shared_ptr <const AnalysisResult> find(const Key& key);
+
+  // Ajoute un résultat en mémoire et retire le plus ancien si la capacité est dépassée.
+  // loaded indique si le résultat a été relu dans le dossier plutôt que calculé.
+  void insert(const Key& key, const shared_ptr <const AnalysisResult>& r, bool loaded);
+
+  // Retourne le nom du fichier du dossier associé à l'empreinte h.
+  string filename(uint64_t h) const;
+
+  // Relit le résultat de clé key dans le dossier, ou nullptr s'il n'y est pas ou est
+  // celui d'une autre image.
+  shared_ptr <const AnalysisResult> load(const Key& key) const;
+
+  // Enregistre un résultat dans le dossier, sous un nom temporaire renommé une fois le
+  // fichier complet. Retourne faux si l'écriture échoue.
+  bool save(const Key& key, const AnalysisResult& r) const;
+};
+
+#endif
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ANALYSIS_RESULT_H
+#define ANALYSIS_RESULT_H
+
+#include <vector>
+#include "Color.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est le résultat complet d'une analyse, détaché de l'image analysée.
+///
+/// Les zones sont numérotées de 0 à nbZones()-1 dans l'ordre de leur premier pixel,
+/// comme le fait Analyst::zoneIndex. Le résultat contient :
+///   - l'image des étiquettes : la zone de chaque pixel;
+///   - la table des zones : la couleur et la liste des pixels de chaque zone;
+///   - les nombres de pixels et de zones de chaque couleur.
+////////////////////////////////////////////////////////////////////////////////
+struct AnalysisResult {
+
+  /// Dimensions de l'image analysée.
+  int width, height;
+
+  /// Voisinage utilisé pour former les zones : 4 ou 8 (voir Analyst).
+  int connectivity;
+
+  /// La zone du pixel numéro k est labels[k].
+  vector <int> labels;
+
+  /// La couleur de chaque zone.
+  vector <Color> zoneColors;
+
+  /// Les pixels de la zone z sont rangés par numéro croissant dans zonePixels,
+  /// entre les positions zoneOffsets[z] et zoneOffsets[z+1].
+  vector <int> zoneOffsets;
+  vector <int> zonePixels;
+
+  /// Le nombre de pixels et de zones de chaque couleur, indexés par Color::toInt().
+  vector <int> pixelsPerColor;
+  vector <int> zonesPerColor;
+
+  /// Retourne le nombre de zones.
+  int nbZones() const;
+
+  /// Retourne le nombre de pixels de la zone z.
+  int zoneSize(int z) const;
+
+  /// Calcule la table des zones et les comptages à partir de labels et zoneColors.
+  void complete();
+};
+
+#endif
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ANALYSIS_SNAPSHOT_H
+#define ANALYSIS_SNAPSHOT_H
+
+#include <memory>
+#include <set>
+#include "Image.h"
+#include "AnalysisResult.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est une analyse figée d'une image, partageable entre fils d'exécution.
+///
+/// Contrairement à Analyst, this partage la propriété de son image et de son
+/// résultat, qui ne sont plus jamais modifiés : toutes les questions sont des
+/// méthodes constantes, sans verrou ni calcul paresseux, et peuvent être posées
+/// simultanément depuis plusieurs fils. Copier un instantané est peu coûteux.
+///
+/// Voici un exemple :
+///
+/// AnalysisSnapshot s(make_shared <const Image>(Image::readAIP("images/amazonie_0")));
+/// // Dans n'importe quel fil :
+/// bool same = s.belongToTheSameZone(0, 0, 3, 4);
+////////////////////////////////////////////////////////////////////////////////
+class AnalysisSnapshot {
+
+public:
+
+  /// Analyse complètement l'image img, dont this partage la propriété, en formant
+  /// les zones selon le voisinage connectivity (4 ou 8, voir Analyst).
+  AnalysisSnapshot(shared_ptr <const Image> img, int connectivity = 4);
+
+  /// Fige un résultat déjà calculé pour l'image img (par exemple issu d'un AnalysisCache).
+  /// Précondition : result est bien l'analyse de img.
+  AnalysisSnapshot(shared_ptr <const Image> img, shared_ptr <const AnalysisResult> result);
+
+  /// Retourne l'image analysée.
+  const Image& getImage() const;
+
+  /// Retourne le résultat complet de l'analyse.
+  const AnalysisResult& getResult() const;
+
+  /// Teste si les pixels de coordonnées (i1, j1) et (i2, j2) font partie d'une même zone.
+  bool belongToTheSameZone(int i1, int j1, int i2, int j2) const;
+
+  /// Retourne le nombre de pixels d'une couleur donnée.
+  int nbPixelsOfColor(Color c) const;
+
+  /// Retourne le nombre de zones d'une couleur donnée.
+  int nbZonesOfColor(Color c) const;
+
+  /// Retourne le nombre de zones.
+  int nbZones() const;
+
+  /// Retourne le numéro, entre 0 et nbZones()-1, de la zone du pixel de coordonnées (i, j).
+  int zoneIndex(int i, int j) const;
+
+  /// Retourne le nombre de pixels de la zone numéro z.
+  int zoneSize(int z) const;
+
+  /// Retourne la couleur de la zone numéro z.
+  Color zoneColor(int z) const;
+
+  /// Retourne les clés de tous les pixels qui appartiennent à la même zone que celui de coordonnées (i, j).
+  set <int> zoneOfPixel(int i, int j) const;
+
+  /// Crée une nouvelle image à partir de celle analysée, en remplissant la zone du pixel
+  /// de coordonnées (i,j) de la couleur c.
+  Image fillZone(int i, int j, Color c) const;
+
+private:
+
+  // L'image analysée, partagée avec les copies de this.
+  shared_ptr <const Image> img;
+
+  // Le résultat de l'analyse, partagé lui aussi.
+  shared_ptr <const AnalysisResult> result;
+};
+
+#endif
@@ -12,19 +12,42 @@
 #include <set>
 #include <list>
 #include "Image.h"
+#include "AnalysisResult.h"
+#include "RegionGraph.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 /// This est une analyse d'image sous forme de partition.
 ///
 /// Une analyse permet de mettre en évidence les différentes zones d'une image.
-/// Une zone est un groupe de pixels de même couleurs reliés entre eux.
+/// Une zone est un groupe de pixels de même couleurs reliés entre eux, soit par leurs
+/// bords (4-connexité, par défaut), soit par leurs bords ou leurs coins (8-connexité,
+/// utile par exemple pour des rivières fines tracées en diagonale).
+///
+/// L'analyse est paresseuse : chaque question ne coûte que ce dont elle a besoin.
+///   - la construction ne parcourt pas l'image;
+///   - la première question de comptage de pixels calcule l'histogramme des couleurs;
+///   - la première question portant sur l'ensemble des zones construit la partition;
+///   - les questions sur une seule zone (zoneOfPixel, fillZone) sont traitées par un
+///     remplissage local tant que la partition n'a pas été construite.
+/// L'image analysée ne doit donc pas être modifiée ni détruite tant que l'analyse est utilisée,
+/// sauf par recolorZones, qui la repeint en tenant l'analyse à jour.
+///
+/// La partition est allouée par une ressource mémoire, par défaut celle du programme. Un fil
+/// qui analyse de nombreuses petites images peut fournir une arène, libérée d'un coup après
+/// chaque image (voir std::pmr::monotonic_buffer_resource).
 ////////////////////////////////////////////////////////////////////////////////
 class Analyst {
   
 public:
 
-  /// Démarre l'analyse d'une image donnée.
-  Analyst(const Image& img);
+  /// Prépare l'analyse d'une image donnée, sans la parcourir.
+  /// Si withGraph est vrai, le graphe d'adjacence des zones est construit en même
+  /// temps que la partition, à partir des contacts relevés lors du même parcours.
+  /// connectivity vaut 4 ou 8 et s'applique à toutes les questions sur les zones,
+  /// ainsi qu'aux contacts du graphe. La partition est allouée par memory, qui doit vivre
+  /// plus longtemps que this.
+  Analyst(const Image& img, bool withGraph = false, int connectivity = 4,
+          pmr::memory_resource* memory = pmr::get_default_resource());
 
   /// Interdit la copie d'analyses.
   Analyst(const Analyst&) = delete;
@@ -32,7 +55,7 @@ public:
   /// Interdit l'affectation d'analyses.
   Analyst& operator=(const Analyst&) = delete;
 
-  /// Destructeur par défaut.
+  /// Destructeur, libère la partition si elle a été construite.
   ~Analyst();
 
   /// Teste si les pixels de coordonnées (i1, j1) et (i2, j2) de l'image
@@ -52,56 +75,156 @@ public:
   /// de coordonnées (i,j) d'une nouvelle couleur en entrée.
   Image fillZone(int i, int j, Color c);
 
+  /// Repeint directement dans img, en un seul parcours, les zones de recolors : chaque paire
+  /// donne le numéro d'une zone (voir zoneIndex) et sa nouvelle couleur. L'analyse suit sans
+  /// être recalculée : comptages de pixels et de zones mis à jour, zones repeintes réunies à
+  /// leurs voisines de même couleur. Les zones sont ensuite renumérotées. Retourne le nombre
+  /// de pixels repeints.
+  /// Précondition : img est l'image analysée et chaque numéro est entre 0 et nbZones()-1.
+  int recolorZones(Image& img, const vector <pair <int, Color>>& recolors);
+
+  /// Repeint comme ci-dessus chaque zone z de couleur c et de size pixels de la couleur
+  /// choose(z, c, size); une zone pour laquelle choose retourne c est laissée telle quelle.
+  /// Par exemple, pour que les zones blanches de moins de 10 pixels deviennent vertes :
+  /// a.recolorZones(img, [](int, Color c, int size) { return c == Color::White && size < 10 ? Color::Green : c; });
+  template <class Choose>
+  int recolorZones(Image& img, Choose choose);
+
   /// Retourne les clés de tous les pixels qui appartiennent à la même zone que celui de coordonnées (i, j).
   set <int> zoneOfPixel(int i, int j);
 
+  /// Retourne le numéro, entre 0 et nbZones()-1, de la zone du pixel de coordonnées (i, j).
+  /// Les zones sont numérotées dans l'ordre de leur premier pixel.
+  int zoneIndex(int i, int j);
+
+  /// Retourne le résultat complet de l'analyse (étiquettes, table des zones, comptages),
+  /// qui ne dépend plus de l'image analysée. Construit la partition si nécessaire.
+  AnalysisResult getResult();
+
+  /// Retourne la connexité de l'analyse, 4 ou 8.
+  int getConnectivity() const;
+
+  /// Retourne vrai si le graphe d'adjacence des zones est demandé.
+  bool hasRegionGraph() const;
+
+  /// Retourne le graphe d'adjacence des zones, dont les sommets suivent la numérotation de zoneIndex.
+  /// Précondition : l'analyse a été démarrée avec withGraph.
+  const RegionGraph& getRegionGraph() const;
+
 private:
 
   // Ce pointeur permet de garder une trace de l'image analysée.
   const Image* pImg;
 
-  // Voici la partition des pixels en zones représentées par chaque sous liste du tableau.
-  vector <list <int>*> part;
+  // Les membres suivants sont calculés à la demande, y compris par les méthodes constantes.
+
+  // Voici la partition des pixels en zones représentées par chaque sous liste du tableau :
+  // part[k] désigne la liste de la zone du pixel k, l'une des listes de lists.
+  // Elle est vide tant qu'aucune question ne porte sur l'ensemble des zones.
+  mutable pmr::vector <pmr::list <int>*> part;
+
+  // Les listes de la partition, une par pixel au départ. Une fusion vide l'une des deux listes.
+  mutable pmr::vector <pmr::list <int>> lists;
 
   // Un tableau dont chaque case contient le nombre d'occurences de la couleur d'identifiant
   // le numéro de la case. Ex : si le nombre 0 représente la couleur Black, alors la case 0 du
   // tableau contient le nombre de pixels noirs (Black) de l'image analysée.
-  vector <int> pixelsPerColor;
+  // Il est vide tant que l'histogramme n'a pas été calculé.
+  mutable vector <int> pixelsPerColor;
   
   // Un tableau dont chaque case contient le nombre de zones de la couleur d'identifiant
   // le numéro de la case. Ex : si le nombre 0 représente la couleur Black, alors la case 0 du
   // tableau contient le nombre de zones noires (Black) de l'image analysée.
-  vector <int> zonesPerColor;
+  mutable vector <int> zonesPerColor;
 
   // Le nombre de pixels de l'image.
   int nbElem;
 
   // Le nombre de zones de l'image.
-  int zones;
+  mutable int zones;
+
+  // Vrai si le graphe d'adjacence des zones doit être construit.
+  bool withGraph;
+
+  // La connexité des zones : 4 ou 8.
+  int connectivity;
+
+  // Les paires de pixels voisins de couleurs différentes relevées pendant la fusion des zones.
+  mutable vector <pair <int, int>> contacts;
+
+  // Le numéro de zone de chaque représentant, vide tant que les zones ne sont pas numérotées.
+  mutable pmr::vector <int> zoneIds;
+
+  // Le graphe d'adjacence des zones.
+  mutable RegionGraph graph;
 
   ////////////////////////////////////////////////////////////////////////////////
 
   // Crée un tableau de taille nbColors et le remplit de 0.
-  vector <int> initZero();
+  vector <int> initZero() const;
+
+  // Calcule l'histogramme des couleurs s'il ne l'a pas encore été.
+  void requireHistogram() const;
+
+  // Construit la partition (et le graphe s'il est demandé) si elle ne l'a pas encore été.
+  void requirePartition() const;
+
+  // Vrai si la partition a été construite.
+  bool isPartitioned() const;
 
   // Initialise la Partition en créant une partie pour chaque pixel.
-  void initPart();
+  void initPart() const;
 
-  // Finalise la Partition en fusionnant les parties des pixels de même zone.
-  void UnionZones();
+  // Finalise la Partition en fusionnant les parties des pixels de même zone. Le parcours
+  // des voisins est généré à la compilation pour chaque connexité.
+  template <int Connectivity>
+  void UnionZones() const;
 
-  // Fusionne les parties des pixels de coordonnées
-  // (i1, j1) et (i2, j2) s'ils sont consécutifs et de même couleur.
-  void Union(int i1, int j1, int i2, int j2);
+  // Fusionne les parties des pixels voisins k1 et k2 s'ils sont de même couleur.
+  void UnionPixels(int k1, int k2) const;
 
   // Fusionne les parties des pixels i et j.
-  void Union(int i, int j);
+  void Union(int i, int j) const;
 
   // Retourne le représentant du pixel de coordonnées (i, j).
-  int Find (const int i, const int j);
+  int Find (const int i, const int j) const;
 
   // Retourne le représentant du pixel k.
-  int Find(const int i);
+  int Find(const int i) const;
+
+  // Numérote les zones dans l'ordre de leur premier pixel.
+  void numberZones() const;
+
+  // Construit le graphe d'adjacence à partir des contacts relevés pendant la fusion.
+  void buildRegionGraph() const;
+
+  // Remplit la table des zones, dans la numérotation de zoneIndex : couleur et nombre de pixels.
+  void zoneTable(vector <Color>& colors, vector <int>& sizes) const;
+
+  // Parcourt la zone du pixel (i, j) sans construire la partition, et appelle visit(k)
+  // sur chacun de ses pixels. isVisited(k) indique si le pixel k a déjà été rencontré.
+  template <int Connectivity, class Visit, class IsVisited>
+  void floodZone(int i, int j, Visit visit, IsVisited isVisited) const;
 };
 
+template <class Choose>
+int Analyst::recolorZones(Image& img, Choose choose) {
+
+  vector <Color> colors;
+  vector <int> sizes;
+
+  zoneTable(colors, sizes);
+
+  vector <pair <int, Color>> recolors;
+
+  for (int z = 0; z < static_cast<int>(colors.size()); ++z) {
+
+    Color c = choose(z, colors[z], sizes[z]);
+
+    if (c != colors[z]) recolors.push_back(make_pair(z, c));
+  }
+
+  return recolorZones(img, recolors);
+}
+
 #endif
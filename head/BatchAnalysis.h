@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BATCH_ANALYSIS_H
+#define BATCH_ANALYSIS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Statistiques de l'analyse d'un fichier AIP.
+struct FileReport {
+
+  /// Nom du fichier, sans son extension (comme pour Image::readAIP).
+  string name;
+
+  /// Vide si l'analyse a réussi, sinon le message de l'erreur rencontrée.
+  string error;
+
+  /// Dimensions de l'image et nombre de zones.
+  int width, height, nbZones;
+
+  /// Le nombre de pixels et de zones de chaque couleur, indexés par Color::toInt().
+  vector <int> pixelsPerColor;
+  vector <int> zonesPerColor;
+};
+
+/// Paramètres d'une analyse par lots.
+struct BatchParameters {
+
+  /// Nombre de fils d'exécution; 0 pour autant que de cœurs.
+  int nbThreads = 0;
+
+  /// Voisinage des zones : 4 ou 8 (voir Analyst).
+  int connectivity = 4;
+};
+
+/// Retourne les noms, sans extension et triés, des fichiers AIP désignés par path :
+/// tous les fichiers '.aip' du dossier path, ou le fichier path lui-même.
+/// Renvoie une exception runtime_error si path n'existe pas.
+vector <string> listAIPFiles(const string& path);
+
+/// Lit et analyse les fichiers names (sans extension) sur un groupe de fils à vol de travail
+/// (voir ThreadPool.h) : la lecture d'un fichier et l'analyse d'un autre se recouvrent.
+/// Retourne un rapport par fichier, dans l'ordre de names. Un fichier illisible donne un
+/// rapport d'erreur sans interrompre les autres.
+vector <FileReport> analyseFiles(const vector <string>& names, const BatchParameters& p = BatchParameters());
+
+/// Écrit les rapports en CSV : une ligne par fichier, avec le nombre de pixels et de zones de chaque couleur.
+void writeReportsCSV(ostream& out, const vector <FileReport>& reports);
+
+/// Écrit les rapports en JSON : un objet par fichier, sur une ligne.
+void writeReportsJSON(ostream& out, const vector <FileReport>& reports);
+
+#endif
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMMAND_SERVER_H
+#define COMMAND_SERVER_H
+
+#include <atomic>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Image.h"
+#include "AnalysisResult.h"
+#include "AnalysisCache.h"
+#include "FireSimulator.h"
+#include "Json.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est un serveur de commandes qui garde en mémoire des sessions de travail :
+/// une image chargée, ses analyses et une simulation d'incendie en cours.
+///
+/// Chaque commande est un objet JSON sur une ligne, chaque réponse aussi. Le champ
+/// "cmd" nomme la commande, "session" la session visée; un champ "id" est recopié
+/// dans la réponse. Une réponse contient "ok": true et ses résultats, ou "ok": false
+/// et "error". Les couleurs sont données par leur nom (black, white, red, blue, green)
+/// ou leur numéro; les pixels par leur ligne "i" et leur colonne "j".
+///   - load {session, file} lit le fichier AIP 'file.aip'; load {session, width, height,
+///     seed} génère un terrain (voir TerrainGenerator.h);
+///   - unload {session} ferme une session, sessions liste les sessions ouvertes;
+///   - stats {session, connectivity} : dimensions, nombre de zones, pixels et zones par couleur;
+///   - zone {session, i, j, connectivity} : numéro, couleur et taille de la zone d'un pixel;
+///   - fill {session, i, j, color, connectivity} repeint la zone d'un pixel dans l'image de la session;
+///   - ignite {session, i, j, seed} démarre une simulation sur une copie de l'image;
+///   - step {session, n} avance la simulation de n étapes (1 par défaut);
+///   - frame {session} : l'image courante (celle de la simulation s'il y en a une), une
+///     chaîne de chiffres AIP par ligne; delta {session} : les pixels [k, couleur] qui ont
+///     changé depuis le dernier frame ou delta;
+///   - save {session, file, format, pixelSize} écrit l'image courante en AIP, SVG, PPM ou PNG;
+///   - shutdown arrête le serveur.
+///
+/// Les analyses sont partagées entre sessions par un AnalysisCache : une image déjà
+/// analysée ne l'est pas une seconde fois. Les commandes de sessions différentes
+/// s'exécutent en parallèle, celles d'une même session l'une après l'autre.
+///
+/// Voici un exemple :
+///
+/// CommandServer server;
+/// server.execute("{\"cmd\": \"load\", \"session\": \"a\", \"file\": \"images/image0\"}");
+/// string reply = server.execute("{\"cmd\": \"zone\", \"session\": \"a\", \"i\": 0, \"j\": 0}");
+////////////////////////////////////////////////////////////////////////////////
+class CommandServer {
+
+public:
+
+  /// Crée un serveur sans session, dont le cache garde au plus cacheCapacity analyses par voisinage.
+  explicit CommandServer(size_t cacheCapacity = 64);
+
+  /// Interdit la copie de serveurs.
+  CommandServer(const CommandServer&) = delete;
+
+  /// Interdit l'affectation de serveurs.
+  CommandServer& operator=(const CommandServer&) = delete;
+
+  /// Exécute la commande line et retourne la réponse, sur une ligne sans retour final.
+  /// Une commande invalide ou qui échoue donne une réponse d'erreur, jamais une exception.
+  /// Peut être appelée depuis plusieurs fils d'exécution.
+  string execute(const string& line);
+
+  /// Exécute les commandes lues sur in, une par ligne, et écrit chaque réponse sur out dès
+  /// qu'elle est prête. S'arrête à la fin de in ou après la commande shutdown.
+  void serve(istream& in, ostream& out);
+
+  /// Écoute sur la socket locale (Unix) path, remplacée si elle existe, et sert chaque
+  /// connexion comme serve depuis son propre fil. Retourne après la commande shutdown,
+  /// une fois toutes les connexions fermées.
+  /// Renvoie une exception runtime_error si la socket ne peut être créée.
+  void serveSocket(const string& path);
+
+  /// Retourne le nombre de sessions ouvertes.
+  int nbSessions() const;
+
+  /// Retourne vrai si la commande shutdown a été reçue.
+  bool isShutdown() const;
+
+private:
+
+  // Une session de travail. Son verrou est pris pendant toute commande qui la vise.
+  struct Session {
+
+    mutex lock;
+
+    // L'image chargée, remplacée (et non modifiée) par fill.
+    shared_ptr <const Image> image;
+
+    // Les analyses de image pour 4 et 8 voisins, nulles tant qu'elles n'ont pas été demandées.
+    shared_ptr <const AnalysisResult> analyses[2];
+
+    // La simulation en cours et l'image qu'elle modifie, nulles s'il n'y en a pas.
+    unique_ptr <Image> simImage;
+    unique_ptr <FireSimulator> simulator;
+
+    // L'image de la dernière réponse frame ou delta, base du delta suivant.
+    unique_ptr <Image> lastSent;
+  };
+
+  mutable mutex sessionsLock;
+  map <string, shared_ptr <Session>> sessions;
+
+  // Les caches d'analyses pour 4 et 8 voisins, partagés par toutes les sessions.
+  AnalysisCache cache4, cache8;
+
+  atomic <bool> stopping;
+
+  // La socket d'écoute de serveSocket (-1 sinon) et les connexions ouvertes, fermées par shutdown.
+  mutex clientsLock;
+  int listenFd;
+  set <int> clients;
+
+  // Les fils des connexions fermées, que serveSocket n'a pas encore joints.
+  vector <thread::id> finishedClients;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Exécute une commande déjà lue et ajoute ses résultats à reply.
+  void dispatch(const JsonValue& request, JsonValue& reply);
+
+  // Retourne la session nommée par le champ "session" de request.
+  shared_ptr <Session> findSession(const JsonValue& request) const;
+
+  // Retourne l'analyse de l'image de s pour le voisinage demandé par request (4 par défaut).
+  // Le verrou de s doit être pris.
+  shared_ptr <const AnalysisResult> analysisOf(Session& s, const JsonValue& request);
+
+  // Les commandes, qui ajoutent leurs résultats à reply.
+  void load(const JsonValue& request, JsonValue& reply);
+  void unload(const JsonValue& request, JsonValue& reply);
+  void listSessions(JsonValue& reply) const;
+  void stats(const JsonValue& request, JsonValue& reply);
+  void zone(const JsonValue& request, JsonValue& reply);
+  void fill(const JsonValue& request, JsonValue& reply);
+  void ignite(const JsonValue& request, JsonValue& reply);
+  void step(const JsonValue& request, JsonValue& reply);
+  void frame(const JsonValue& request, JsonValue& reply);
+  void delta(const JsonValue& request, JsonValue& reply);
+  void save(const JsonValue& request, JsonValue& reply);
+  void stop();
+
+  // Sert une connexion de serveSocket jusqu'à sa fermeture.
+  void serveClient(int fd);
+};
+
+#endif
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CONTOUR_SET_H
+#define CONTOUR_SET_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "Image.h"
+#include "AnalysisResult.h"
+
+using namespace std;
+
+/// Un contour fermé : la suite de ses sommets, sans répéter le premier.
+/// Chaque sommet (x, y) est un coin de pixel : x est la colonne, entre 0 et width,
+/// et y la ligne, entre 0 et height. Le pixel (i, j) occupe le carré de coins (j, i) et (j+1, i+1).
+typedef vector <pair <int, int>> ContourRing;
+
+/// Le contour d'une zone.
+struct ZonePolygon {
+
+  /// Numéro de la zone dans l'analyse d'origine (voir Analyst::zoneIndex).
+  int zone;
+
+  /// Couleur de la zone.
+  Color color;
+
+  /// rings[0] est le bord extérieur de la zone, parcouru dans le sens des aiguilles d'une
+  /// montre à l'écran; les suivants sont ses trous, parcourus dans l'autre sens.
+  vector <ContourRing> rings;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est un ensemble de contours de zones, extraits d'une analyse.
+///
+/// Chaque zone donne un polygone à trous dont les sommets sont des coins de pixels.
+/// Seuls les changements de direction sont conservés : un rectangle a quatre sommets
+/// quelle que soit sa taille. Le coût du tracé est proportionnel au nombre de pixels
+/// des zones tracées, et la taille du résultat à la longueur de leurs bords.
+///
+/// Les contours peuvent être simplifiés (Douglas-Peucker), puis écrits en SVG (un
+/// chemin par zone, remplissage pair-impair) ou dans un format binaire compact
+/// ('.aic' : entiers de longueur variable, sommets codés par différence).
+///
+/// Voici un exemple :
+///
+/// Analyst a(frame);
+/// ContourSet front(a.getResult(), Color::Red); // Les pixels en feu.
+/// front.simplify(0.5);
+/// front.writeSVG("svg/front", 20);
+/// front.writeBinary("front");
+////////////////////////////////////////////////////////////////////////////////
+class ContourSet {
+
+public:
+
+  /// Trace les contours de toutes les zones de couleur c de l'analyse result.
+  ContourSet(const AnalysisResult& result, Color c);
+
+  /// Analyse img selon connectivity (4 ou 8), puis trace les contours de ses zones de couleur c.
+  ContourSet(const Image& img, Color c, int connectivity = 4);
+
+  /// Retourne les contours de la seule zone numéro zone de l'analyse result.
+  /// Précondition : 0 <= zone < result.nbZones().
+  static ContourSet ofZone(const AnalysisResult& result, int zone);
+
+  /// Retourne les contours enregistrés par writeBinary dans le fichier 'filename.aic'.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  static ContourSet readBinary(const string& filename);
+
+  /// Retourne la largeur de l'image d'origine.
+  int getWidth() const;
+
+  /// Retourne la hauteur de l'image d'origine.
+  int getHeight() const;
+
+  /// Retourne les contours de chaque zone, par numéro de zone croissant.
+  const vector <ZonePolygon>& getPolygons() const;
+
+  /// Retourne le nombre total de sommets.
+  int nbPoints() const;
+
+  /// Simplifie chaque contour (Douglas-Peucker) : les sommets retirés sont à moins de
+  /// tolerance pixels du contour simplifié. Un contour garde au moins trois sommets.
+  void simplify(double tolerance);
+
+  /// Génère une image au format SVG 'filename.svg', à la même échelle que Image::writeSVG.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writeSVG(const string& filename, int pixelSize) const;
+
+  /// Enregistre les contours dans le fichier binaire 'filename.aic'.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writeBinary(const string& filename) const;
+
+private:
+
+  int width, height;
+
+  vector <ZonePolygon> polygons;
+
+  // Ensemble vide pour une image de dimensions w*h.
+  ContourSet(int w, int h);
+
+  // Ajoute le contour de la zone z de result.
+  void traceZone(const AnalysisResult& result, int z);
+};
+
+#endif
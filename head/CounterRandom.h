@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include <cstdint>
+
+/// Mélange les bits d'un entier : deux entrées proches donnent des sorties sans rapport.
+inline uint32_t mixBits(uint32_t h) {
+
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+
+    return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Générateur aléatoire sans état : le tirage ne dépend que de la graine, d'un
+/// compteur (par exemple l'étape d'une simulation) et d'une clé (par exemple un
+/// pixel). Les tirages peuvent donc être faits dans n'importe quel ordre, par
+/// n'importe quel fil, et donnent toujours le même résultat.
+////////////////////////////////////////////////////////////////////////////////
+inline uint32_t counterRandom(uint32_t seed, uint32_t counter, uint32_t key) {
+
+    return mixBits(mixBits(seed ^ mixBits(counter * 0x9E3779B1u + 0x632BE5ABu)) ^ (key * 0x85EBCA77u));
+}
+
+#endif
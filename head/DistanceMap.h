@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISTANCE_MAP_H
+#define DISTANCE_MAP_H
+
+#include <cstdint>
+#include <vector>
+#include "Image.h"
+
+/// Les distances entre pixels disponibles.
+enum class Metric { Euclidean, Manhattan };
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est une carte des distances d'une image.
+///
+/// Chaque pixel reçoit la distance exacte, en pixels, qui le sépare du plus proche
+/// pixel source, c'est-à-dire d'un pixel dont la couleur appartient à un ensemble
+/// donné (par exemple l'eau, Color::Blue, ou le front de feu, Color::Red).
+///
+/// Le calcul est séparable et linéaire en la taille de l'image : une première passe
+/// traite les colonnes, une seconde les lignes (enveloppe inférieure de paraboles
+/// pour la distance euclidienne). Chaque passe est répartie sur plusieurs fils.
+///
+/// T est le type des distances stockées : float, ou uint16_t pour une carte compacte
+/// dont les distances euclidiennes sont arrondies à l'entier le plus proche.
+///
+/// Voici un exemple :
+///
+/// DistanceMap <float> water(img, { Color::Blue });
+/// float d = water.getDistance(i, j);
+/// water.update(nextImg); // Étape suivante, sans réallocation.
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class DistanceMap {
+
+public:
+
+  /// Calcule la carte des distances de img aux pixels dont la couleur appartient à sources.
+  /// Si nbThreads vaut 0, autant de fils que de cœurs sont utilisés.
+  DistanceMap(const Image& img, const vector <Color>& sources, Metric metric = Metric::Euclidean, int nbThreads = 0);
+
+  /// Recalcule la carte sur une nouvelle image de mêmes dimensions en réutilisant la mémoire
+  /// déjà allouée. Permet de suivre chaque étape d'une simulation à moindre coût.
+  void update(const Image& img);
+
+  /// Retourne la largeur de la carte.
+  int getWidth() const;
+
+  /// Retourne la hauteur de la carte.
+  int getHeight() const;
+
+  /// Retourne la distance du pixel (i, j) au plus proche pixel source,
+  /// ou infinity() si l'image ne contient aucun pixel source.
+  T getDistance(int i, int j) const;
+
+  /// Retourne les distances de tous les pixels, le pixel (i, j) étant rangé à la case i*w + j.
+  const vector <T>& getData() const;
+
+  /// Retourne la valeur donnée aux pixels sans source atteignable.
+  static T infinity();
+
+private:
+
+  int width, height;
+
+  Metric metric;
+
+  int nbThreads;
+
+  // Vrai à la case c si la couleur d'identifiant c est une couleur source.
+  vector <bool> isSource;
+
+  // Distance de chaque pixel au plus proche pixel source de sa colonne.
+  vector <int> columnDist;
+
+  // Les distances finales.
+  vector <T> dist;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Remplit columnDist pour les colonnes de first à last-1.
+  void columnPass(const Image& img, int first, int last);
+
+  // Remplit dist pour les lignes de first à last-1, selon la distance euclidienne.
+  void euclideanRowPass(int first, int last);
+
+  // Remplit dist pour les lignes de first à last-1, selon la distance de Manhattan.
+  void manhattanRowPass(int first, int last);
+};
+
+template <> float DistanceMap <float>::infinity();
+template <> uint16_t DistanceMap <uint16_t>::infinity();
+
+extern template class DistanceMap <float>;
+extern template class DistanceMap <uint16_t>;
+
+#endif
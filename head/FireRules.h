@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIRE_RULES_H
+#define FIRE_RULES_H
+
+#include <utility>
+#include <vector>
+#include "Color.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Combustibles : quelles couleurs de pixels peuvent brûler.
+////////////////////////////////////////////////////////////////////////////////
+
+/// Seule la forêt brûle.
+struct ForestFuel {
+
+    static bool isFuel(Color c) { return c == Color::Green; }
+};
+
+/// La forêt et les terrains découverts (Color::White) brûlent.
+struct ForestAndFieldFuel {
+
+    static bool isFuel(Color c) { return c == Color::Green || c == Color::White; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Modèles de propagation : parmi les pixels de combustible qui touchent un feu,
+/// lesquels s'enflamment à l'étape suivante.
+///
+/// select(riskZone, random) range en tête de riskZone (un tableau d'entiers, quel que soit
+/// son allocateur) les pixels qui s'enflamment et retourne leur nombre. random(key) fournit
+/// un entier aléatoire de 32 bits.
+/// isLocal est vrai si la décision pour un pixel ne dépend que de ce pixel.
+////////////////////////////////////////////////////////////////////////////////
+
+/// Modèle d'origine : entre 1 et tous les pixels à risque s'enflamment, choisis au hasard.
+struct UniformCountSpread {
+
+    static const bool isLocal = false;
+
+    template <class RiskZone, class Random>
+    static int select(RiskZone& riskZone, Random& random) {
+
+        int max = riskZone.size();
+
+        if (max == 0) return 0;
+
+        int toAdd = (random(0) % max) + 1;
+
+        // Tirage sans remise : les toAdd premières cases reçoivent des pixels tirés parmi les restants.
+        for (int n = 0; n < toAdd; ++n) {
+
+            int r = n + random(n + 1) % (max - n);
+
+            swap(riskZone[n], riskZone[r]);
+        }
+
+        return toAdd;
+    }
+};
+
+/// Chaque pixel à risque s'enflamme indépendamment avec une probabilité de Percent %.
+template <int Percent>
+struct BernoulliSpread {
+
+    static_assert(Percent >= 0 && Percent <= 100, "percent must be between 0 and 100");
+
+    static const bool isLocal = true;
+
+    /// Décide si le pixel k s'enflamme.
+    template <class Random>
+    static bool ignites(int k, Random& random) {
+
+        return random(k) % 100 < static_cast<unsigned>(Percent);
+    }
+
+    template <class RiskZone, class Random>
+    static int select(RiskZone& riskZone, Random& random) {
+
+        int kept = 0;
+
+        for (size_t n = 0; n < riskZone.size(); ++n) {
+
+            if (ignites(riskZone[n], random)) swap(riskZone[kept++], riskZone[n]);
+        }
+
+        return kept;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Règles d'une simulation d'incendie, fixées à la compilation.
+///
+///   - Connectivity : le feu se propage aux 4 voisins d'un pixel, ou aux 8;
+///   - BurnDuration : nombre d'étapes pendant lesquelles un pixel brûle avant de devenir cendre (2 au moins);
+///   - Fuel : les couleurs qui brûlent (ForestFuel, ForestAndFieldFuel...);
+///   - Spread : le modèle de propagation (UniformCountSpread, BernoulliSpread <P>...).
+///
+/// Toute classe offrant les mêmes membres peut servir de règles à BasicFireSimulator.
+////////////////////////////////////////////////////////////////////////////////
+template <int Connectivity, int BurnDuration, class Fuel, class SpreadModel>
+struct FireRules {
+
+    static_assert(Connectivity == 4 || Connectivity == 8, "connectivity must be 4 or 8");
+    // nextStage éteint les feux arrivés à leur terme avant de chercher les pixels qu'ils menacent :
+    // un feu d'une seule étape s'éteindrait avant de pouvoir se propager.
+    static_assert(BurnDuration >= 2, "burn duration must be at least 2");
+
+    static const int connectivity = Connectivity;
+    static const int burnDuration = BurnDuration;
+
+    typedef SpreadModel Spread;
+
+    static bool isFuel(Color c) { return Fuel::isFuel(c); }
+
+    static Color fireColor() { return Color::Red; }
+
+    static Color ashColor() { return Color::Black; }
+};
+
+/// Les règles d'origine du simulateur : 4 voisins, 3 étapes de combustion, la forêt
+/// comme seul combustible, flammes rouges et cendres noires.
+typedef FireRules <4, 3, ForestFuel, UniformCountSpread> DefaultFireRules;
+
+#endif
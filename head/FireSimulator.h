@@ -9,9 +9,17 @@
 #ifndef FIRE_SIMULATOR_H
 #define FIRE_SIMULATOR_H
 
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <string>
 #include <vector>
-#include <set>
 #include "Image.h"
+#include "FrameWriter.h"
+#include "Neighbourhood.h"
+#include "ThreadPool.h"
+#include "FireRules.h"
 
 // Représente un feu sur le pixel k, allumé lors de l'étape lightTime.
 struct Fire {
@@ -30,83 +38,254 @@ struct Fire {
     }
 };
 
+/// Bilan d'une simulation menée jusqu'à l'extinction de l'incendie.
+struct FireSummary {
+
+    /// Nombre d'étapes effectuées jusqu'à l'extinction.
+    int steps;
+
+    /// Nombre de pixels réduits en cendres.
+    int burnedCells;
+
+    /// Nombre maximal de pixels en feu au même moment.
+    int peakFrontier;
+
+    /// ashMap[k] est vrai si le pixel numéro k a brûlé.
+    vector <bool> ashMap;
+};
+
+/// Manière dont les pixels donnés à un simulateur déclenchent l'incendie.
+enum class Ignition {
+    RandomInZone, // Un départ de feu tiré au hasard dans la zone de forêt de chaque pixel.
+    AtPixels      // Un départ de feu sur chacun des pixels.
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// This simule l'expérience d'un feu de forêt.
 ///
-/// À partir d'un pixel de forêt d'une image, un feu est simulé dans la zone
-/// de forêt de ce pixel.
+/// À partir d'un ou de plusieurs pixels de forêt d'une image, un feu est simulé
+/// dans les zones de forêt de ces pixels. Tous les foyers avancent ensemble à
+/// chaque étape : le coût d'une étape dépend du nombre de pixels en feu, pas du
+/// nombre de foyers.
+///
+/// Les règles de la simulation (voisinage, durée de combustion, combustibles,
+/// modèle de propagation) sont fixées à la compilation par le paramètre Rules
+/// (voir FireRules.h) : la boucle de chaque étape est générée avec ces constantes,
+/// sans test à l'exécution. FireSimulator utilise les règles d'origine.
+///
+/// Les tirages aléatoires ne dépendent que de la graine, de l'étape et du pixel
+/// concerné (voir CounterRandom.h). Lorsque le modèle de propagation est local
+/// (Rules::Spread::isLocal), l'image peut être découpée en bandes de lignes
+/// traitées chacune par un fil d'exécution : le résultat est le même quel que
+/// soit le nombre de fils.
+///
+/// Les états et les listes de pixels de la simulation sont alloués par une ressource
+/// mémoire, par défaut celle du programme, qui peut être une arène propre à un fil.
 ////////////////////////////////////////////////////////////////////////////////
-class FireSimulator {
+template <class Rules>
+class BasicFireSimulator {
 
 public:
 
     // Prépare les données pour une simulation d'incendie sur l'image img, dans la zone
     // de forêt du pixel k.
-    FireSimulator(Image& img, int k);
-    
+    BasicFireSimulator(Image& img, int k);
+
     // Prépare les données pour une simulation d'incendie sur l'image img, dans la zone
     // de forêt du pixel de coordonnées (i,j).
-    FireSimulator(Image& img, int i, int j);
+    BasicFireSimulator(Image& img, int i, int j);
+
+    // Prépare les données pour une simulation d'incendie sur l'image img, dans les zones
+    // de forêt des pixels de ignitions. Selon mode, le feu démarre au hasard une fois dans
+    // chacune de ces zones, ou sur chacun des pixels.
+    // Les états et listes de pixels de la simulation sont alloués par memory, qui doit vivre
+    // plus longtemps que this.
+    BasicFireSimulator(Image& img, const vector <int>& ignitions, Ignition mode = Ignition::RandomInZone,
+                       pmr::memory_resource* memory = pmr::get_default_resource());
+
+    // Reprend la simulation enregistrée par save dans le fichier 'filename.aif'. this possède
+    // alors l'image simulée, que getImage permet de copier. La simulation est sur un seul fil.
+    // Renvoie une exception runtime_error si le fichier est illisible ou a été produit avec
+    // d'autres règles.
+    explicit BasicFireSimulator(const string& filename, pmr::memory_resource* memory = pmr::get_default_resource());
 
-    // Destructeur, désalloue la mémoire.
-    ~FireSimulator();
+    // Destructeur, désalloue la mémoire. L'image simulée, si elle appartient à l'appelant, est conservée.
+    ~BasicFireSimulator();
 
     // Fais avancer la simulation de n étapes.
-    // Produit les fichier .aip correspondant à chaque étape.
+    // Produit les fichier .aip correspondant à chaque étape, écrits en arrière-plan pendant
+    // les étapes suivantes et tous complets au retour.
     // Retourne les images de chacune des étapes effectuées.
     vector <Image> runSimulator(int n);
 
+    // Fais avancer la simulation de n étapes en confiant l'écriture des fichiers .aip à writer.
+    // Les fichiers ne sont complets qu'après writer.flush().
+    // Retourne les images de chacune des étapes effectuées.
+    vector <Image> runSimulator(int n, FrameWriter& writer);
+
+    // Fais avancer la simulation jusqu'à ce qu'aucun pixel ne brûle plus, sans produire de fichier.
+    // S'arrête dès l'étape où le dernier feu s'éteint et retourne le bilan de la simulation.
+    FireSummary runUntilExtinct();
+
     // Fais avancer la simulation d'une étape.
     void nextStage();
 
-    // Retourne l'image de la simulation à l'étape courante. 
+    // Retourne vrai si l'incendie a démarré et qu'aucun pixel ne brûle plus.
+    // Les étapes suivantes ne changeraient plus rien.
+    bool isExtinct() const;
+
+    // Retourne le nombre de pixels en feu à l'étape courante.
+    int nbBurning() const;
+
+    // Retourne l'image de la simulation à l'étape courante.
     Image getImage();
 
     // Retourne l'étape courante.
     int getTime();
 
+    // Enregistre l'état complet de la simulation (image, état des pixels, étape, feux, graine)
+    // dans le fichier binaire 'filename.aif'. Une simulation reprise de ce fichier continue
+    // exactement comme this l'aurait fait.
+    // Renvoie une exception runtime_error si une erreur survient.
+    void save(const string& filename) const;
+
+    // Fixe la graine des tirages aléatoires. Par défaut, elle dépend de l'heure de création.
+    // Deux simulations de mêmes départs et de même graine sont identiques.
+    void setSeed(uint32_t seed);
+
+    // Découpe l'image en nbThreads bandes de lignes, avancées en parallèle à chaque étape
+    // (autant que de cœurs si nbThreads vaut 0 ou moins, au plus une par ligne). Sans effet si
+    // le modèle de propagation n'est pas local, comme celui de FireSimulator : la simulation
+    // reste alors sur un seul fil.
+    // Retourne le nombre de bandes effectivement utilisées, 1 pour un modèle non local.
+    int setThreadCount(int nbThreads);
+
 private:
 
+    // État d'un pixel au cours de la simulation.
+    enum CellState : uint8_t {
+        Inert,   // Hors de la zone de forêt : ne brûlera jamais.
+        Fuel,    // Combustible intact.
+        AtRisk,  // Combustible touchant un feu, pendant le calcul d'une étape.
+        Burning, // En feu.
+        Ash      // Cendres : un feu ne peut plus s'y déclarer.
+    };
+
+    // Les lignes firstRow à lastRow exclue de l'image, possédées par un fil d'exécution.
+    // Seul ce fil modifie l'état de leurs pixels.
+    // Les listes d'une bande gardent leur capacité d'une étape à l'autre : en régime établi,
+    // une étape n'alloue presque plus rien.
+    struct Band {
+
+        int firstRow, lastRow;
+
+        // Définit la zone incendiée de la bande, par ordre d'allumage. Chaque pixel dans
+        // cette zone y est pour une durée temporaire (Rules::burnDuration).
+        pmr::deque <Fire> fireZone;
+
+        // Les pixels allumés et éteints depuis le dernier rafraîchissement de l'image.
+        pmr::vector <int> ignited;
+        pmr::vector <int> extinguished;
+
+        // Les pixels de la bande en contact avec un feu, pendant le calcul d'une étape.
+        pmr::vector <int> riskZone;
+
+        // Les pixels des bandes du dessus et du dessous en contact avec un feu de la bande,
+        // transmis à ces bandes entre les deux phases d'une étape.
+        pmr::vector <int> haloUp;
+        pmr::vector <int> haloDown;
+
+        // Crée une bande vide des lignes firstRow à lastRow exclue, dont les listes sont allouées par memory.
+        Band(int firstRow, int lastRow, pmr::memory_resource* memory)
+            : firstRow(firstRow), lastRow(lastRow), fireZone(memory), ignited(memory), extinguished(memory),
+              riskZone(memory), haloUp(memory), haloDown(memory) {}
+    };
+
     // Repère temporel sur l'état de la simulation. Commence à 0 et s'incrémente à chaque étape.
     int experienceTime;
 
-    // Une copie modifiable de l'image de départ de la simulation.
+    // Graine des tirages aléatoires.
+    uint32_t seed;
+
+    // L'image de départ de la simulation, fournie par l'appelant et modifiée à chaque étape.
     Image* currentImg;
 
-    // Définit la zone de forêt dans laquelle l'incendie se déclare. Il ne peut se propager en dehors.
-    set <int> limitZone;
+    // L'image simulée lorsqu'elle a été relue d'un point de reprise, nulle sinon.
+    unique_ptr <Image> ownedImg;
+
+    // La ressource mémoire des états et des listes de pixels.
+    pmr::memory_resource* memory;
+
+    // Définit les zones de forêt dans lesquelles l'incendie se déclare. Il ne peut se propager en dehors.
+    // Les pixels de chaque zone y sont contigus : la zone z occupe les positions zoneStarts[z]
+    // à zoneStarts[z+1] exclue.
+    pmr::vector <int> limitZone;
+    pmr::vector <int> zoneStarts;
 
-    // Définit l'ensembe des pixels de cendres, issues d'un incendie qui s'est éteint. Un feu ne peut pas s'y déclarer.
-    set <int> dustZone;
+    // Les départs de feu imposés (Ignition::AtPixels), vide si ceux-ci sont tirés au hasard.
+    pmr::vector <int> startPixels;
 
-    // Définit la zone incendiée. Chaque pixel dans cette zone y est pour une durée temporaire (3 temps).
-    set <Fire> fireZone;
+    // L'état de chaque pixel de l'image, qui remplace les ensembles de pixels de forêt et de cendres.
+    pmr::vector <uint8_t> cells;
+
+    // Les bords touchés par chaque pixel : les voisins d'un feu sont trouvés sans division.
+    unique_ptr <PixelBorders> borders;
+
+    // Version du format des points de reprise, écrite après les 4 octets "AIPF".
+    static const uint32_t checkpointVersion = 1;
+
+    // Les bandes de l'image, de haut en bas. Une seule bande couvre toute l'image tant
+    // que setThreadCount n'a pas été appelée avec un modèle de propagation local.
+    vector <Band> bands;
+
+    // Les fils qui avancent les bandes 1 à nb-1 à chaque étape, nul s'il n'y a qu'une bande.
+    unique_ptr <ThreadPool> pool;
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    // Détermine aléatoirement l'emplacement du départ de feu parmi les pixels de limitZone.
-    // L'ajoute à fireZone. Appelée une fois au début de l'expérience.
+    // Allume les départs de feu imposés, ou en détermine aléatoirement un par zone de limitZone.
+    // Les ajoute à fireZone. Appelée une fois au début de l'expérience.
     void lightFire();
 
-    // Vérifie quels feux doivent être éteints, les retire de fireZone et les ajoute à dustzone.
-    // Appelée à chaque stade de l'expérience à partir du 3e temps. 
-    void extinguishFire();
+    // Vérifie quels feux de la bande b doivent être éteints, les retire de sa fireZone et
+    // les ajoute aux cendres.
+    void extinguishFire(int b);
+
+    // Liste dans riskZone les pixels de forêt de la bande b en contact avec un de ses
+    // pixels de flammes, et dans ses halos ceux des bandes voisines.
+    void unsafeList(int b);
 
-    // Étend la zone de feu en définissant aléatoirement quels pixels, parmi
-    // ceux présents dans riskZone, sont ajoutés à fireZone.
-    void spreadFire(vector <int> & riskZone);
+    // Ajoute à la riskZone de la bande b les pixels de ses halos transmis par les bandes voisines.
+    void receiveHalos(int b);
 
-    // Incrémente experienceTime et actualise l'image courante.
-    void runTime();
+    // Étend la zone de feu de la bande b en choisissant, selon Rules::Spread, quels pixels
+    // parmi ceux présents dans sa riskZone sont ajoutés à sa fireZone.
+    void spreadFire(int b);
 
-    // Actualise l'image courante à partir de fireZone et dustZone.
-    void refreshImage();
+    // Actualise les lignes de la bande b de l'image courante à partir des pixels allumés
+    // et éteints depuis le dernier appel.
+    void refreshImage(int b);
 
-    // Vrai si le pixel de coordonnées (i2, j2) est une zone de forêt qui touche une zone de flammes.
-    bool isUnsafe(int i1, int j1, int i2, int j2);
+    // Appelle f(b) pour chaque bande b, en parallèle sur les fils de pool s'il y a plusieurs bandes.
+    template <class Function>
+    void forEachBand(Function f);
 
-    // Liste de tous les pixels de forêt en contact avec un pixel de flammes.
-    vector <int> unsafeList();
+    // Retourne la bande qui possède le pixel k.
+    int bandOf(int k) const;
+
+    // Range les feux fires, triés par ordre d'allumage puis par pixel, dans leurs bandes.
+    void distributeFires(vector <Fire>& fires);
+
+    // Retourne un entier aléatoire de 32 bits pour la clé key à l'étape courante.
+    unsigned random(unsigned key) const;
 };
 
+/// Le simulateur aux règles d'origine.
+typedef BasicFireSimulator <DefaultFireRules> FireSimulator;
+
+#include "FireSimulator.tpp"
+
+// Les règles d'origine sont compilées une seule fois, dans FireSimulator.cpp.
+extern template class BasicFireSimulator <DefaultFireRules>;
+
 #endif
@@ -0,0 +1,780 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+// Définitions des méthodes de BasicFireSimulator, incluses par FireSimulator.h.
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <time.h>
+#include "CounterRandom.h"
+#include "Metrics.h"
+#include "Neighbourhood.h"
+#include "Parallel.h"
+
+template <class Rules>
+BasicFireSimulator <Rules>::BasicFireSimulator(Image& img, const vector <int>& ignitions, Ignition mode,
+                                               pmr::memory_resource* memory)
+    : memory(memory), limitZone(memory), zoneStarts(memory), startPixels(memory), cells(memory) {
+
+    assert(!ignitions.empty());
+
+    currentImg = &img;
+
+    int w = img.getWidth();
+    int h = img.getHeight();
+
+    cells.assign(img.getSize(), Inert);
+    borders.reset(new PixelBorders(w, h, memory));
+
+    const PixelBorders& edges = *borders;
+
+    // Les pixels de combustible reliés à un nouveau pixel de la zone y sont ajoutés.
+    auto visit = [this, &img](int n) {
+
+        if (cells[n] == Inert && Rules::isFuel(img.getPixel(n))) {
+
+            cells[n] = Fuel;
+            limitZone.push_back(n);
+        }
+    };
+
+    // Définition des zones de forêt dans lesquelles se déclare et se propage l'incendie :
+    // les pixels de combustible reliés à chaque départ selon le voisinage des règles.
+    for (int k : ignitions) {
+
+        // Vérification de la couleur du pixel où démarre l'incendie.
+        assert(k >= 0 && k < img.getSize());
+        assert(Rules::isFuel(img.getPixel(k)));
+
+        // Le pixel appartient à une zone déjà parcourue.
+        if (cells[k] != Inert) continue;
+
+        zoneStarts.push_back(limitZone.size());
+
+        cells[k] = Fuel;
+        limitZone.push_back(k);
+
+        // La fin de limitZone sert aussi de file d'attente du parcours.
+        for (size_t next = zoneStarts.back(); next < limitZone.size(); ++next) {
+
+            int n = limitZone[next];
+
+            NeighbourLoop <Rules::connectivity>::apply(n, edges[n], w, visit);
+        }
+    }
+
+    zoneStarts.push_back(limitZone.size());
+
+    // Chaque départ imposé n'est retenu qu'une fois : il est marqué le temps du tri.
+    if (mode == Ignition::AtPixels) {
+
+        for (int k : ignitions) {
+
+            if (cells[k] == Fuel) {
+
+                cells[k] = AtRisk;
+                startPixels.push_back(k);
+            }
+        }
+
+        for (int k : startPixels) {
+
+            cells[k] = Fuel;
+        }
+    }
+
+    // Une seule bande couvre d'abord toute l'image.
+    bands.push_back(Band(0, h, memory));
+
+    // Le moment de la simulation est initialisé à 0.
+    experienceTime = 0;
+    seed = static_cast<uint32_t>(time(nullptr));
+}
+
+// Délègue au constructeur général avec une seule zone de départ : appeler ce dernier
+// dans le corps ne créerait qu'un simulateur temporaire.
+template <class Rules>
+BasicFireSimulator <Rules>::BasicFireSimulator(Image& img, int k)
+    : BasicFireSimulator(img, vector <int>(1, k)) {
+}
+
+template <class Rules>
+BasicFireSimulator <Rules>::BasicFireSimulator(Image& img, int i, int j)
+    : BasicFireSimulator(img, vector <int>(1, img.toIndex(i, j))) {
+}
+
+// Format d'un point de reprise, en binaire :
+//   - les 4 octets "AIPF" puis la version du format (32 bits);
+//   - le voisinage, la durée de combustion et le caractère local des règles, la largeur et la
+//     hauteur de l'image, l'étape, le nombre de feux, puis les tailles de limitZone, zoneStarts
+//     et startPixels (32 bits chacun), et la graine (32 bits);
+//   - la couleur de chaque pixel (un octet par pixel), puis son état (un octet par pixel);
+//   - chaque feu, dans l'ordre des bandes : son pixel et son étape d'allumage (32 bits chacun);
+//   - limitZone, zoneStarts et startPixels (32 bits par valeur). Après l'allumage, seul l'état
+//     des pixels compte : ces listes sont alors vides dans le fichier et limitZone est recalculée.
+template <class Rules>
+BasicFireSimulator <Rules>::BasicFireSimulator(const string& filename, pmr::memory_resource* memory)
+    : memory(memory), limitZone(memory), zoneStarts(memory), startPixels(memory), cells(memory) {
+
+    ifstream file(filename + ".aif", ios::binary);
+
+    if (!file) throw runtime_error("error open file (read checkpoint)");
+
+    char magic[4];
+    uint32_t version;
+    int32_t header[10];
+
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&seed), sizeof(seed));
+
+    if (!file || memcmp(magic, "AIPF", 4) != 0 || version != checkpointVersion) {
+
+        throw runtime_error("error read file (read checkpoint)");
+    }
+
+    // Un point de reprise ne peut être repris qu'avec les règles qui l'ont produit.
+    if (header[0] != Rules::connectivity || header[1] != Rules::burnDuration || header[2] != Rules::Spread::isLocal) {
+
+        throw runtime_error("error rules mismatch (read checkpoint)");
+    }
+
+    int w = header[3];
+    int h = header[4];
+
+    experienceTime = header[5];
+
+    if (w < 1 || h < 1 || experienceTime < 0 || header[6] < 0 || header[7] < 0 || header[8] < 0 || header[9] < 0) {
+
+        throw runtime_error("error read file (read checkpoint)");
+    }
+
+    // Les tailles sont calculées sur 64 bits et comparées à ce qui reste du fichier avant
+    // toute allocation : un en-tête falsifié ne peut demander plus que le fichier ne contient.
+    long long pixels = static_cast<long long>(w) * h;
+
+    if (pixels > INT_MAX) throw runtime_error("error read file (read checkpoint)");
+
+    long long expected = 2 * pixels + 2 * static_cast<long long>(sizeof(int32_t)) * header[6]
+                       + static_cast<long long>(sizeof(int32_t)) * (static_cast<long long>(header[7]) + header[8] + header[9]);
+
+    streampos start = file.tellg();
+    file.seekg(0, ios::end);
+    long long remaining = static_cast<long long>(file.tellg() - start);
+    file.seekg(start);
+
+    if (!file || remaining != expected) throw runtime_error("error read file (read checkpoint)");
+
+    ownedImg.reset(new Image(w, h));
+    currentImg = ownedImg.get();
+    borders.reset(new PixelBorders(w, h, memory));
+
+    int size = static_cast<int>(pixels);
+
+    vector <uint8_t> colors(size);
+    cells.resize(size);
+
+    file.read(reinterpret_cast<char*>(colors.data()), size);
+    file.read(reinterpret_cast<char*>(cells.data()), size);
+
+    vector <int32_t> fireData(2 * static_cast<size_t>(header[6]));
+    limitZone.resize(header[7]);
+    zoneStarts.resize(header[8]);
+    startPixels.resize(header[9]);
+
+    file.read(reinterpret_cast<char*>(fireData.data()), fireData.size() * sizeof(int32_t));
+    file.read(reinterpret_cast<char*>(limitZone.data()), limitZone.size() * sizeof(int));
+    file.read(reinterpret_cast<char*>(zoneStarts.data()), zoneStarts.size() * sizeof(int));
+    file.read(reinterpret_cast<char*>(startPixels.data()), startPixels.size() * sizeof(int));
+
+    if (!file) throw runtime_error("error read file (read checkpoint)");
+
+    for (int k = 0; k < size; ++k) {
+
+        if (colors[k] >= Color::nbColors() || cells[k] > Ash) throw runtime_error("error read file (read checkpoint)");
+
+        currentImg->setPixel(k, Color::makeColor(colors[k]));
+    }
+
+    vector <Fire> fires;
+
+    for (size_t n = 0; n < fireData.size(); n += 2) {
+
+        Fire f;
+        f.k = fireData[n];
+        f.lightTime = fireData[n + 1];
+
+        if (f.k < 0 || f.k >= size || cells[f.k] != Burning) throw runtime_error("error read file (read checkpoint)");
+
+        fires.push_back(f);
+    }
+
+    // Après l'allumage, limitZone ne sert plus qu'à retrouver les pixels de la zone de forêt.
+    if (experienceTime > 0) {
+
+        for (int k = 0; k < size; ++k) {
+
+            if (cells[k] != Inert) limitZone.push_back(k);
+        }
+
+        zoneStarts.assign(1, 0);
+        zoneStarts.push_back(limitZone.size());
+    }
+
+    for (int k : limitZone) {
+
+        if (k < 0 || k >= size) throw runtime_error("error read file (read checkpoint)");
+    }
+
+    for (int k : startPixels) {
+
+        if (k < 0 || k >= size) throw runtime_error("error read file (read checkpoint)");
+    }
+
+    // Chaque zone de limitZone doit être une suite non vide de pixels.
+    for (size_t z = 0; z < zoneStarts.size(); ++z) {
+
+        int previous = (z == 0) ? -1 : zoneStarts[z - 1];
+
+        if (zoneStarts[z] <= previous || zoneStarts[z] > static_cast<int>(limitZone.size())) {
+
+            throw runtime_error("error read file (read checkpoint)");
+        }
+    }
+
+    bands.push_back(Band(0, h, memory));
+
+    // Un modèle global dépend de l'ordre des feux, qui est conservé tel quel. Un modèle local
+    // range ses feux dans un ordre qui ne dépend pas du découpage en bandes.
+    if (Rules::Spread::isLocal) distributeFires(fires);
+
+    else bands[0].fireZone.assign(fires.begin(), fires.end());
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::save(const string& filename) const {
+
+    ofstream file(filename + ".aif", ios::binary);
+
+    if (!file) throw runtime_error("error open file (write checkpoint)");
+
+    int w = currentImg->getWidth();
+    int size = currentImg->getSize();
+
+    vector <int32_t> fireData;
+
+    for (const Band& band : bands) {
+
+        for (const Fire& f : band.fireZone) {
+
+            fireData.push_back(f.k);
+            fireData.push_back(f.lightTime);
+        }
+    }
+
+    bool lit = experienceTime > 0;
+
+    int32_t header[10] = { Rules::connectivity, Rules::burnDuration, Rules::Spread::isLocal, w, currentImg->getHeight(),
+                           experienceTime, static_cast<int32_t>(fireData.size() / 2),
+                           lit ? 0 : static_cast<int32_t>(limitZone.size()),
+                           lit ? 0 : static_cast<int32_t>(zoneStarts.size()),
+                           lit ? 0 : static_cast<int32_t>(startPixels.size()) };
+
+    vector <uint8_t> colors(size);
+
+    for (int k = 0; k < size; ++k) {
+
+        colors[k] = currentImg->getPixel(k).toInt();
+    }
+
+    uint32_t version = checkpointVersion;
+
+    file.write("AIPF", 4);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+    file.write(reinterpret_cast<const char*>(colors.data()), size);
+    file.write(reinterpret_cast<const char*>(cells.data()), size);
+    file.write(reinterpret_cast<const char*>(fireData.data()), fireData.size() * sizeof(int32_t));
+
+    if (!lit) {
+
+        file.write(reinterpret_cast<const char*>(limitZone.data()), limitZone.size() * sizeof(int));
+        file.write(reinterpret_cast<const char*>(zoneStarts.data()), zoneStarts.size() * sizeof(int));
+        file.write(reinterpret_cast<const char*>(startPixels.data()), startPixels.size() * sizeof(int));
+    }
+
+    if (!file) throw runtime_error("error write file (write checkpoint)");
+}
+
+template <class Rules>
+BasicFireSimulator <Rules>::~BasicFireSimulator() {
+
+    limitZone.clear();
+    bands.clear();
+    cells.clear();
+
+    // L'image simulée appartient à l'appelant : elle n'est pas détruite ici.
+    currentImg = nullptr;
+}
+
+template <class Rules>
+vector <Image> BasicFireSimulator <Rules>::runSimulator(int n) {
+
+    FrameWriter writer;
+
+    vector <Image> tab = runSimulator(n, writer);
+
+    writer.flush();
+
+    return tab;
+}
+
+template <class Rules>
+vector <Image> BasicFireSimulator <Rules>::runSimulator(int n, FrameWriter& writer) {
+
+    assert(n >= 0);
+
+    vector <Image> tab;
+
+    // Ajout de l'image courante avant la moindre modification.
+    tab.push_back(getImage());
+
+    string name = ("images/image" + to_string(experienceTime));
+
+    writer.writeAIP(tab[0], name);
+
+    // À chaque étape, on ajoute l'image courante et on demande son fichier .aip,
+    // écrit pendant que la simulation continue.
+    for (int i = 1; i <= n; ++i) {
+
+        nextStage();
+
+        tab.push_back(getImage());
+
+        name = ("images/image" + to_string(experienceTime));
+        writer.writeAIP(tab[i], name);
+    }
+
+    return tab;
+}
+
+template <class Rules>
+FireSummary BasicFireSimulator <Rules>::runUntilExtinct() {
+
+    FireSummary summary;
+
+    summary.steps = 0;
+    summary.peakFrontier = nbBurning();
+
+    // Chaque étape consomme du combustible, ou éteint des feux sans en allumer : l'incendie finit par s'éteindre.
+    while (!isExtinct()) {
+
+        nextStage();
+
+        ++summary.steps;
+        summary.peakFrontier = max(summary.peakFrontier, nbBurning());
+    }
+
+    // Seuls les pixels de limitZone ont pu brûler.
+    summary.burnedCells = 0;
+    summary.ashMap.assign(cells.size(), false);
+
+    for (int k : limitZone) {
+
+        if (cells[k] == Ash) {
+
+            summary.ashMap[k] = true;
+            ++summary.burnedCells;
+        }
+    }
+
+    return summary;
+}
+
+template <class Rules>
+bool BasicFireSimulator <Rules>::isExtinct() const {
+
+    return experienceTime > 0 && nbBurning() == 0;
+}
+
+template <class Rules>
+int BasicFireSimulator <Rules>::nbBurning() const {
+
+    int n = 0;
+
+    for (const Band& band : bands) {
+
+        n += band.fireZone.size();
+    }
+
+    return n;
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::nextStage() {
+
+    int nb = bands.size();
+
+    if (experienceTime == 0) {
+
+        lightFire();
+
+        for (int b = 0; b < nb; ++b) {
+
+            refreshImage(b);
+        }
+    }
+
+    else {
+
+        // Première phase : chaque bande éteint ses feux et repère les pixels qu'ils menacent,
+        // y compris ceux des bandes voisines, sans lire ni modifier leur état.
+        forEachBand([this](int b) {
+
+            if (experienceTime >= Rules::burnDuration) {
+
+                extinguishFire(b);
+            }
+
+            unsafeList(b);
+        });
+
+        // Seconde phase, une fois les halos de toutes les bandes connus : chaque bande
+        // décide quels pixels menacés s'enflamment et actualise ses lignes de l'image.
+        forEachBand([this](int b) {
+
+            receiveHalos(b);
+
+            spreadFire(b);
+
+            refreshImage(b);
+        });
+    }
+
+    ++experienceTime;
+
+    // La ligne du relevé est terminée par le programme qui mène la simulation (voir Metrics.h) :
+    // plusieurs simulateurs peuvent avancer en même temps sans mélanger leurs étapes.
+    AIP_COUNT("fire.burning", nbBurning());
+}
+
+template <class Rules>
+template <class Function>
+void BasicFireSimulator <Rules>::forEachBand(Function f) {
+
+    int nb = bands.size();
+
+    // Les bandes 1 à nb-1 sont confiées aux fils du groupe, déjà démarrés; la bande 0 reste au
+    // fil appelant, qui attend ensuite les autres.
+    for (int b = 1; b < nb; ++b) {
+
+        pool->submit([&f, b]() { f(b); });
+    }
+
+    f(0);
+
+    if (nb > 1) pool->wait();
+}
+
+template <class Rules>
+unsigned BasicFireSimulator <Rules>::random(unsigned key) const {
+
+    return counterRandom(seed, experienceTime, key);
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::setSeed(uint32_t seed) {
+
+    this->seed = seed;
+}
+
+template <class Rules>
+int BasicFireSimulator <Rules>::setThreadCount(int nbThreads) {
+
+    // Un modèle global choisit parmi tous les pixels menacés à la fois : il ne se découpe pas.
+    if (!Rules::Spread::isLocal) return 1;
+
+    // Les changements d'état pas encore reportés sur l'image le sont avant le découpage.
+    for (int b = 0; b < static_cast<int>(bands.size()); ++b) {
+
+        refreshImage(b);
+    }
+
+    vector <Fire> fires;
+
+    for (const Band& band : bands) {
+
+        fires.insert(fires.end(), band.fireZone.begin(), band.fireZone.end());
+    }
+
+    int h = currentImg->getHeight();
+    int nb = min(defaultThreadCount(nbThreads), h);
+
+    bands.clear();
+
+    // Des bandes de hauteurs égales, à une ligne près.
+    for (int b = 0; b < nb; ++b) {
+
+        bands.push_back(Band(static_cast<int>(static_cast<long long>(h) * b / nb),
+                             static_cast<int>(static_cast<long long>(h) * (b + 1) / nb), memory));
+    }
+
+    distributeFires(fires);
+
+    // Les fils qui avancent les bandes sont démarrés ici, une fois pour toute la simulation.
+    pool.reset(nb > 1 ? new ThreadPool(nb - 1) : nullptr);
+
+    return nb;
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::lightFire() {
+
+    assert(experienceTime == 0);
+
+    vector <int> starts(startPixels.begin(), startPixels.end());
+
+    // Définition aléatoire de l'indice du départ de feu de chaque zone.
+    if (starts.empty()) {
+
+        for (size_t z = 0; z + 1 < zoneStarts.size(); ++z) {
+
+            int size = zoneStarts[z + 1] - zoneStarts[z];
+
+            starts.push_back(limitZone[zoneStarts[z] + random(z) % size]);
+        }
+    }
+
+    AIP_COUNT("fire.ignited", starts.size());
+
+    // Ajout des départs de feu à la liste des feux.
+    vector <Fire> fires;
+
+    for (int k : starts) {
+
+        Fire f;
+        f.k = k;
+        f.lightTime = experienceTime;
+
+        cells[f.k] = Burning;
+        fires.push_back(f);
+        bands[bandOf(k)].ignited.push_back(k);
+    }
+
+    distributeFires(fires);
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::extinguishFire(int b) {
+
+    assert(experienceTime >= Rules::burnDuration);
+
+    AIP_TIMER("fire.extinguishFire");
+
+    Band& band = bands[b];
+
+    // Les feux sont rangés par ordre d'allumage : ceux qui brûlent depuis
+    // Rules::burnDuration étapes sont en tête et laissent place à la cendre.
+    while (!band.fireZone.empty() && experienceTime - band.fireZone.front().lightTime >= Rules::burnDuration) {
+
+        int k = band.fireZone.front().k;
+
+        cells[k] = Ash;
+        band.extinguished.push_back(k);
+
+        band.fireZone.pop_front();
+    }
+
+    AIP_COUNT("fire.extinguished", band.extinguished.size());
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::unsafeList(int b) {
+
+    // La riskZone de la bande contient les pixels en danger. C'est dans cette liste que seront
+    // piochés au hasard les pixels qui s'enflammeront lors de la prochaine étape de la simulation.
+    // Chaque pixel n'y figure qu'une fois.
+    AIP_TIMER("fire.unsafeList");
+
+    Band& band = bands[b];
+
+    band.riskZone.clear();
+    band.haloUp.clear();
+    band.haloDown.clear();
+
+    int w = currentImg->getWidth();
+
+    const PixelBorders& edges = *borders;
+
+    int first = band.firstRow * w;
+    int last = band.lastRow * w;
+
+    // Si un voisin est du combustible intact, il risque de s'enflammer : il est ajouté à la riskZone.
+    // Un voisin d'une autre bande est confié à celle-ci, qui seule connaît son état.
+    auto visit = [this, &band, first, last](int n) {
+
+        if (n < first) band.haloUp.push_back(n);
+
+        else if (n >= last) band.haloDown.push_back(n);
+
+        else if (cells[n] == Fuel) {
+
+            cells[n] = AtRisk;
+            band.riskZone.push_back(n);
+        }
+    };
+
+    // On parcourt l'ensemble des pixels enflammés de la bande.
+    for (const Fire& f : band.fireZone) {
+
+        NeighbourLoop <Rules::connectivity>::apply(f.k, edges[f.k], w, visit);
+    }
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::receiveHalos(int b) {
+
+    AIP_TIMER("fire.receiveHalos");
+
+    Band& band = bands[b];
+
+    auto receive = [this, &band](const pmr::vector <int>& halo) {
+
+        for (int n : halo) {
+
+            if (cells[n] == Fuel) {
+
+                cells[n] = AtRisk;
+                band.riskZone.push_back(n);
+            }
+        }
+    };
+
+    if (b > 0) receive(bands[b - 1].haloDown);
+
+    if (b + 1 < static_cast<int>(bands.size())) receive(bands[b + 1].haloUp);
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::spreadFire(int b) {
+
+    AIP_TIMER("fire.spreadFire");
+
+    Band& band = bands[b];
+
+    auto rnd = [this](unsigned key) { return random(key); };
+
+    int toAdd = Rules::Spread::select(band.riskZone, rnd);
+
+    AIP_COUNT("fire.frontier", band.riskZone.size());
+    AIP_COUNT("fire.ignited", toAdd);
+
+    // Avec un modèle local, les pixels qui s'enflamment ne dépendent pas de l'ordre de la
+    // riskZone : triés, ils rangent les feux dans le même ordre quel que soit le découpage.
+    if (Rules::Spread::isLocal) {
+
+        sort(band.riskZone.begin(), band.riskZone.begin() + toAdd);
+    }
+
+    // Les toAdd premiers pixels s'enflamment.
+    for (int n = 0; n < toAdd; ++n) {
+
+        Fire f;
+        f.k = band.riskZone[n];
+        f.lightTime = experienceTime;
+
+        cells[f.k] = Burning;
+        band.fireZone.push_back(f);
+        band.ignited.push_back(f.k);
+    }
+
+    // Les autres redeviennent du simple combustible.
+    for (size_t n = toAdd; n < band.riskZone.size(); ++n) {
+
+        cells[band.riskZone[n]] = Fuel;
+    }
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::refreshImage(int b) {
+
+    AIP_TIMER("fire.refreshImage");
+
+    Band& band = bands[b];
+
+    AIP_COUNT("fire.repainted", band.ignited.size() + band.extinguished.size());
+
+    // Seuls les pixels qui ont changé d'état depuis le dernier appel sont repeints.
+    for (int k : band.ignited) {
+
+        // Place sur l'image actuelle le pixel en feu.
+        currentImg->setPixel(k, Rules::fireColor());
+    }
+
+    for (int k : band.extinguished) {
+
+        // Place sur l'image actuelle le pixel éteint.
+        currentImg->setPixel(k, Rules::ashColor());
+    }
+
+    band.ignited.clear();
+    band.extinguished.clear();
+}
+
+template <class Rules>
+int BasicFireSimulator <Rules>::bandOf(int k) const {
+
+    int row = k / currentImg->getWidth();
+
+    // Première bande dont la fin est au-delà de la ligne du pixel.
+    int lo = 0, hi = bands.size() - 1;
+
+    while (lo < hi) {
+
+        int mid = (lo + hi) / 2;
+
+        if (bands[mid].lastRow <= row) lo = mid + 1;
+
+        else hi = mid;
+    }
+
+    return lo;
+}
+
+template <class Rules>
+void BasicFireSimulator <Rules>::distributeFires(vector <Fire>& fires) {
+
+    sort(fires.begin(), fires.end(), [](const Fire& a, const Fire& b) {
+
+        return a.lightTime < b.lightTime || (a.lightTime == b.lightTime && a.k < b.k);
+    });
+
+    for (const Fire& f : fires) {
+
+        bands[bandOf(f.k)].fireZone.push_back(f);
+    }
+}
+
+template <class Rules>
+Image BasicFireSimulator <Rules>::getImage() {
+
+    return (*currentImg);
+}
+
+template <class Rules>
+int BasicFireSimulator <Rules>::getTime() {
+
+    return experienceTime;
+}
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FIXED_IMAGE_H
+#define FIXED_IMAGE_H
+
+#include <array>
+#include <cassert>
+#include <string>
+#include <utility>
+#include "Image.h"
+#include "PixelGrid.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est une image de dimensions W*H fixées à la compilation.
+///
+/// Les pixels sont rangés dans l'objet lui-même, sans allocation : une tuile
+/// déclarée dans une fonction vit sur la pile. Les conversions entre coordonnées
+/// et numéros de pixels sont constexpr, et toutes les boucles ont des bornes
+/// constantes que le compilateur peut dérouler.
+///
+/// FixedImage offre les mêmes accès aux pixels qu'Image : les opérations de
+/// PixelGrid.h (numérotation des zones, écriture AIP et SVG) s'appliquent aux deux.
+///
+/// Voici un exemple, pour des tuiles de 64x64 découpées dans une mosaïque :
+///
+/// FixedImage <64, 64> chip;
+/// int labels[64 * 64];
+/// for (int i0 = 0; i0 + 64 <= mosaic.getHeight(); i0 += 64) {
+///   for (int j0 = 0; j0 + 64 <= mosaic.getWidth(); j0 += 64) {
+///     chip.copyFrom(mosaic, i0, j0);
+///     int zones = labelZones <4>(chip, labels);
+///   }
+/// }
+////////////////////////////////////////////////////////////////////////////////
+template <int W, int H>
+class FixedImage {
+
+  static_assert(W >= 1 && H >= 1, "a fixed image has at least one pixel");
+
+public:
+
+  /// Crée une image de la couleur col (noire par défaut).
+  explicit FixedImage(Color col = Color::Black) {
+
+    fill(col);
+  }
+
+  /// Crée la tuile de la mosaïque mosaic dont le coin supérieur gauche est (i0, j0).
+  /// Précondition : la tuile est entièrement dans mosaic.
+  FixedImage(const Image& mosaic, int i0, int j0) {
+
+    copyFrom(mosaic, i0, j0);
+  }
+
+  /// Retourne la largeur (width) de this.
+  static constexpr int getWidth() { return W; }
+
+  /// Retourne la hauteur (height) de this.
+  static constexpr int getHeight() { return H; }
+
+  /// Retourne le nombre de pixels de this.
+  static constexpr int getSize() { return W * H; }
+
+  /// Retourne le numéro k du pixel de coordonnées (i, j).
+  static constexpr int toIndex(int i, int j) { return i * W + j; }
+
+  /// Retourne les coordonnées (i,j) du pixel numéro k. W étant une constante, la division
+  /// est remplacée par une multiplication (ou un décalage si W est une puissance de 2).
+  static constexpr pair <int, int> toCoordinate(int k) { return pair <int, int>(k / W, k % W); }
+
+  /// Retourne la couleur du pixel de la ligne i et de la colonne j.
+  /// Précondition : 0 <= i < H et 0 <= j < W.
+  Color getPixel(int i, int j) const {
+
+    assert(0 <= i && i < H && 0 <= j && j < W);
+
+    return pixels[toIndex(i, j)];
+  }
+
+  /// Insère la couleur col dans le pixel de coordonnées (i,j).
+  /// Précondition : 0 <= i < H et 0 <= j < W.
+  void setPixel(int i, int j, Color col) {
+
+    assert(0 <= i && i < H && 0 <= j && j < W);
+
+    pixels[toIndex(i, j)] = col;
+  }
+
+  /// Remplit this de la couleur col.
+  void fill(Color col) {
+
+    for (int k = 0; k < W * H; ++k) pixels[k] = col;
+  }
+
+  /// Remplit un rectangle, partie de this, de la couleur col.
+  /// (i1, j1) est le coin supérieur gauche, (i2, j2) le coin inférieur droit.
+  /// Précondition : (i1,j1) et (i2,j2) sont des coordonnées valides.
+  void fillRectangle(int i1, int j1, int i2, int j2, Color col) {
+
+    assert(0 <= i1 && i1 <= i2 && i2 < H && 0 <= j1 && j1 <= j2 && j2 < W);
+
+    for (int i = i1; i <= i2; ++i) {
+
+      for (int j = j1; j <= j2; ++j) pixels[toIndex(i, j)] = col;
+    }
+  }
+
+  /// Copie dans this la tuile de mosaic dont le coin supérieur gauche est (i0, j0).
+  /// Précondition : la tuile est entièrement dans mosaic.
+  void copyFrom(const Image& mosaic, int i0, int j0) {
+
+    assert(0 <= i0 && i0 + H <= mosaic.getHeight() && 0 <= j0 && j0 + W <= mosaic.getWidth());
+
+    for (int i = 0; i < H; ++i) {
+
+      for (int j = 0; j < W; ++j) pixels[toIndex(i, j)] = mosaic.getPixel(i0 + i, j0 + j);
+    }
+  }
+
+  /// Recopie this dans mosaic, le coin supérieur gauche en (i0, j0).
+  /// Précondition : la tuile est entièrement dans mosaic.
+  void copyTo(Image& mosaic, int i0, int j0) const {
+
+    assert(0 <= i0 && i0 + H <= mosaic.getHeight() && 0 <= j0 && j0 + W <= mosaic.getWidth());
+
+    for (int i = 0; i < H; ++i) {
+
+      for (int j = 0; j < W; ++j) mosaic.setPixel(i0 + i, j0 + j, pixels[toIndex(i, j)]);
+    }
+  }
+
+  /// Retourne une image (de taille variable) qui a le contenu de this.
+  Image toImage() const {
+
+    Image img(W, H);
+
+    copyTo(img, 0, 0);
+
+    return img;
+  }
+
+  /// Retourne vrai si this et img sont égales.
+  bool operator==(const FixedImage& img) const {
+
+    return pixels == img.pixels;
+  }
+
+  /// Retourne vrai si this et img sont différentes.
+  bool operator!=(const FixedImage& img) const {
+
+    return !(*this == img);
+  }
+
+  /// Génère le fichier 'filename.svg' (voir Image::writeSVG).
+  void writeSVG(const string& filename, int pixelSize) const {
+
+    writeSVGFile(*this, filename, pixelSize);
+  }
+
+  /// Génère le fichier 'filename.aip' (voir Image::writeAIP).
+  void writeAIP(const string& filename) const {
+
+    writeAIPFile(*this, filename);
+  }
+
+private:
+
+  /// Les pixels ligne après ligne : le pixel (i, j) est pixels[i*W + j].
+  array <Color, W * H> pixels;
+};
+
+#endif
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Image.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This écrit des images sur le disque en arrière-plan.
+///
+/// Chaque demande d'écriture copie l'image dans une file bornée, vidée par des
+/// fils d'écriture qui produisent les fichiers AIP ou SVG. L'appelant reprend
+/// aussitôt son calcul : il n'attend que si la file est pleine, ce qui borne la
+/// mémoire occupée par les images en attente.
+///
+/// Les fichiers ne sont complets qu'après flush, qui relance aussi la première
+/// erreur d'écriture rencontrée.
+///
+/// Voici un exemple :
+///
+/// FrameWriter writer;
+/// for (int t = 1; t <= n; ++t) {
+///   f.nextStage();
+///   writer.writeAIP(f.getImage(), "images/image" + to_string(t));
+/// }
+/// writer.flush();
+////////////////////////////////////////////////////////////////////////////////
+class FrameWriter {
+
+public:
+
+  /// Démarre nbThreads fils d'écriture, avec une file d'au plus capacity images.
+  FrameWriter(int nbThreads = 1, int capacity = 8);
+
+  /// Attend l'écriture des images en file, puis arrête les fils.
+  /// Une erreur d'écriture non relancée par flush est ignorée.
+  ~FrameWriter();
+
+  /// Interdit la copie d'écrivains.
+  FrameWriter(const FrameWriter&) = delete;
+
+  /// Interdit l'affectation d'écrivains.
+  FrameWriter& operator=(const FrameWriter&) = delete;
+
+  /// Demande l'écriture de img dans le fichier 'filename.aip' (voir Image::writeAIP).
+  /// Attend qu'une place se libère si la file est pleine.
+  void writeAIP(const Image& img, const string& filename);
+
+  /// Demande l'écriture de img dans le fichier 'filename.svg' (voir Image::writeSVG).
+  /// Attend qu'une place se libère si la file est pleine.
+  void writeSVG(const Image& img, const string& filename, int pixelSize);
+
+  /// Attend que toutes les images demandées soient écrites.
+  /// Renvoie la première exception levée par une écriture depuis le dernier appel.
+  void flush();
+
+  /// Retourne le nombre d'images demandées mais pas encore écrites.
+  int nbPending();
+
+private:
+
+  // Une copie de l'image à écrire et le fichier à produire.
+  struct Frame {
+
+    Image img;
+    string filename;
+    int pixelSize; // 0 pour un fichier AIP.
+  };
+
+  deque <unique_ptr <Frame>> frames;
+  int capacity;
+
+  // Nombre d'images en file ou en cours d'écriture.
+  int pending;
+
+  bool stopping;
+
+  mutex lock;
+  condition_variable notEmpty;
+  condition_variable notFull;
+  condition_variable allWritten;
+
+  // Première exception levée par une écriture.
+  exception_ptr failure;
+
+  vector <thread> threads;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Ajoute une image à la file, en attendant une place si nécessaire.
+  void push(const Image& img, const string& filename, int pixelSize);
+
+  // Boucle d'un fil d'écriture.
+  void run();
+};
+
+#endif
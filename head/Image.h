@@ -9,6 +9,10 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <memory_resource>
 #include <utility>
 #include <string>
 #include <vector>
@@ -25,10 +29,13 @@ public:
 
   /// Crée une image rectangulaire noire de dimensions w*h pixels.
   /// w est la largeur de l'image (width), h est sa hauteur (height).
-  Image(int w, int h);
+  /// Les pixels sont alloués par memory (par exemple une arène réutilisée d'une image à l'autre),
+  /// qui doit vivre plus longtemps que this.
+  /// Renvoie une exception runtime_error si w*h dépasse INT_MAX.
+  Image(int w, int h, pmr::memory_resource* memory = pmr::get_default_resource());
 
-  /// Constructeur qui fait de this une copie de img. 
-  Image(const Image& img);
+  /// Constructeur qui fait de this une copie de img, dont les pixels sont alloués par memory.
+  Image(const Image& img, pmr::memory_resource* memory = pmr::get_default_resource());
 
   /// Destructeur par défaut.
   ~Image();
@@ -36,6 +43,9 @@ public:
   /// Interdit l'affectation d'image.
   Image& operator=(const Image& img) = delete;
 
+  /// Retourne la ressource mémoire qui alloue les pixels de this.
+  pmr::memory_resource* getMemoryResource() const;
+
   /// Retourne la largeur (width) de this.
   int getWidth() const;
 
@@ -60,12 +70,38 @@ public:
   /// Dans le réusltat p, p.first est la ligne i et p.second est la colonne j. 
   pair <int, int> toCoordinate(int k) const;
 
+  /// Retourne la couleur du pixel numéro k (voir toIndex), sans passer par ses coordonnées.
+  /// Précondition : 0 <= k < getSize().
+  Color getPixel(int k) const;
+
+  /// Insère la couleur col dans le pixel numéro k.
+  /// Précondition : 0 <= k < getSize().
+  void setPixel(int k, Color col);
+
+  /// Appelle visit(k, col) pour chaque pixel de this, par numéro k croissant, col étant la couleur
+  /// du pixel k. Pour une image non constante, col est une référence : visit peut repeindre le pixel.
+  /// Les pixels sont parcourus directement, sans calcul de coordonnées ni vérification par pixel.
+  template <class Visit>
+  void forEachPixel(Visit visit) const;
+
+  template <class Visit>
+  void forEachPixel(Visit visit);
+
+  /// Comme forEachPixel, pour les seuls pixels du rectangle de coin supérieur gauche (i1, j1)
+  /// et de coin inférieur droit (i2, j2).
+  /// Précondition : (i1,j1) et (i2,j2) sont des coordonnées valides.
+  template <class Visit>
+  void forEachInRect(int i1, int j1, int i2, int j2, Visit visit) const;
+
+  template <class Visit>
+  void forEachInRect(int i1, int j1, int i2, int j2, Visit visit);
+
   /// Remplit this de la couleur col.
   void fill(Color col);
 
   /// Remplit un rectangle, partie de this, de la couleur col.
   /// (i1, j1) est le coin supérieur gauche.
-  /// (i2, j2) est le coin inférieur gauche.
+  /// (i2, j2) est le coin inférieur droit.
   /// Précondition : (i1,j1) et (i2,j2) sont des coordonnées valides.
   void fillRectangle(int i1, int j1, int i2, int j2, Color c);
   
@@ -90,8 +126,9 @@ public:
 
   /// Crée une image à partir d'un fichier AIP.
   /// Le nom du fichier doit être donné sans son extension.
-  /// Renvoie une exception runtime_error si une erreur survient.
-  static Image readAIP(const string& filename);
+  /// Renvoie une exception runtime_error si une erreur survient, notamment si l'en-tête
+  /// annonce plus de maxPixels pixels (au plus INT_MAX).
+  static Image readAIP(const string& filename, long long maxPixels = INT_MAX);
 
   /// Retourne vrai si this et img sont égales.
   bool operator==(const Image& img) const;
@@ -99,16 +136,29 @@ public:
   /// Retourne vrai si this et img sont différentes.
   bool operator!=(const Image& img) const;
 
+  /// Retourne les numéros, par ordre croissant, des pixels dont la couleur diffère entre this et img.
+  /// Les pixels sont comparés par paquets de 8 : le coût suit la taille de l'image divisée par 8,
+  /// plus le nombre de différences.
+  /// Précondition : img a les dimensions de this.
+  vector <int> changedPixels(const Image& img) const;
+
+  /// Retourne une empreinte sur 64 bits du contenu de this (dimensions et pixels).
+  /// Deux images égales ont la même empreinte.
+  uint64_t hash() const;
+
   /// Retourne vrai si (i1, j1) et (i2, j2) sont deux pixels consécutifs et qui appartiennent à this.
-  bool areConsecutivePixels(int i1, int j1, int i2, int j2) const;
+  /// Avec connectivity = 4, des pixels consécutifs se touchent par un bord; avec connectivity = 8,
+  /// par un bord ou par un coin.
+  bool areConsecutivePixels(int i1, int j1, int i2, int j2, int connectivity = 4) const;
 
 private:
 
   /// height est la hauteur de this et width en est la largeur.
   int height, width;
 
-  /// pixelTab est un tableau 2D de couleurs, représentant les pixels de l'image. 
-  vector <vector <Color>> pixelTab;
+  /// pixels est le tableau des couleurs des pixels de l'image, ligne après ligne :
+  /// le pixel (i, j) est pixels[i*width + j].
+  pmr::vector <Color> pixels;
 
   ////////////////////////////////////////////////////////////////////////////////
   
@@ -116,6 +166,66 @@ private:
   bool isValidCoordinate(int i, int j) const;
 };
 
+// Les accès par numéro sont définis ici pour être développés dans les boucles qui les appellent.
+inline Color Image::getPixel(int k) const {
+
+  assert(0 <= k && k < height * width);
+
+  return pixels[k];
+}
+
+inline void Image::setPixel(int k, Color col) {
+
+  assert(0 <= k && k < height * width);
+
+  pixels[k] = col;
+}
+
+template <class Visit>
+void Image::forEachPixel(Visit visit) const {
+
+  const Color* p = pixels.data();
+  int n = height * width;
+
+  for (int k = 0; k < n; ++k) visit(k, p[k]);
+}
+
+template <class Visit>
+void Image::forEachPixel(Visit visit) {
+
+  Color* p = pixels.data();
+  int n = height * width;
+
+  for (int k = 0; k < n; ++k) visit(k, p[k]);
+}
+
+template <class Visit>
+void Image::forEachInRect(int i1, int j1, int i2, int j2, Visit visit) const {
+
+  assert(isValidCoordinate(i1, j1) && isValidCoordinate(i2, j2));
+
+  const Color* p = pixels.data();
+
+  // Le premier pixel de chaque ligne du rectangle est obtenu en ajoutant width au précédent.
+  for (int first = i1 * width + j1, last = i2 * width + j1; first <= last; first += width) {
+
+    for (int k = first; k <= first + (j2 - j1); ++k) visit(k, p[k]);
+  }
+}
+
+template <class Visit>
+void Image::forEachInRect(int i1, int j1, int i2, int j2, Visit visit) {
+
+  assert(isValidCoordinate(i1, j1) && isValidCoordinate(i2, j2));
+
+  Color* p = pixels.data();
+
+  for (int first = i1 * width + j1, last = i2 * width + j1; first <= last; first += width) {
+
+    for (int k = first; k <= first + (j2 - j1); ++k) visit(k, p[k]);
+  }
+}
+
 /// Génère une image de largeur w et de hauteur h tout en attribuant des couleurs aléatoires aux pixels de this.
 Image makeRandomImage(int w, int h);
 
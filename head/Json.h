@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est une valeur JSON : null, booléen, nombre, chaîne, tableau ou objet.
+///
+/// Juste ce qu'il faut pour échanger des commandes d'une ligne avec le serveur
+/// (voir CommandServer.h) : lecture d'un texte, consultation des champs, et
+/// construction puis écriture d'une réponse sur une seule ligne. Les membres
+/// d'un objet gardent leur ordre d'insertion.
+///
+/// Voici un exemple :
+///
+/// JsonValue request = JsonValue::parse("{\"cmd\": \"zone\", \"i\": 3}");
+/// int i = request.getInt("i", 0);
+/// JsonValue reply = JsonValue::object();
+/// reply.set("ok", true);
+/// string line = reply.toString(); // {"ok":true}
+////////////////////////////////////////////////////////////////////////////////
+class JsonValue {
+
+public:
+
+  /// Les types de valeurs JSON.
+  enum Type { Null, Bool, Number, String, Array, Object };
+
+  /// Crée la valeur null.
+  JsonValue();
+
+  /// Crée un booléen.
+  JsonValue(bool b);
+
+  /// Crée un nombre.
+  JsonValue(int n);
+  JsonValue(double x);
+
+  /// Crée une chaîne.
+  JsonValue(const string& s);
+  JsonValue(const char* s);
+
+  /// Retourne un tableau vide.
+  static JsonValue array();
+
+  /// Retourne un objet vide.
+  static JsonValue object();
+
+  /// Lit le texte JSON text, qui ne contient qu'une valeur.
+  /// Renvoie une exception runtime_error si text n'est pas du JSON valide.
+  static JsonValue parse(const string& text);
+
+  /// Retourne le type de this.
+  Type getType() const;
+
+  /// Retourne la valeur de this. Précondition : this est du type correspondant.
+  bool asBool() const;
+  double asNumber() const;
+  const string& asString() const;
+
+  /// Retourne le nombre d'éléments d'un tableau ou de membres d'un objet.
+  int size() const;
+
+  /// Retourne l'élément n d'un tableau. Précondition : 0 <= n < size().
+  const JsonValue& at(int n) const;
+
+  /// Ajoute value à la fin d'un tableau.
+  void push(const JsonValue& value);
+
+  /// Retourne vrai si l'objet this a un membre key, de valeur non nulle.
+  bool has(const string& key) const;
+
+  /// Retourne le membre key de l'objet this, ou null s'il n'existe pas.
+  const JsonValue& get(const string& key) const;
+
+  /// Donne la valeur value au membre key de l'objet this, ajouté s'il n'existait pas.
+  void set(const string& key, const JsonValue& value);
+
+  /// Retourne le membre key d'un objet comme entier, ou fallback s'il est absent.
+  /// Renvoie une exception runtime_error si le membre n'est pas un nombre entier.
+  int getInt(const string& key, int fallback) const;
+
+  /// Retourne le membre key d'un objet comme chaîne, ou fallback s'il est absent.
+  /// Renvoie une exception runtime_error si le membre n'est pas une chaîne.
+  string getString(const string& key, const string& fallback) const;
+
+  /// Écrit this en JSON, sur une seule ligne et sans espaces.
+  string toString() const;
+
+private:
+
+  Type type;
+
+  bool boolean;
+  double number;
+  string text;
+
+  // Les éléments d'un tableau.
+  vector <JsonValue> elements;
+
+  // Les membres d'un objet, dans leur ordre d'insertion.
+  vector <pair <string, JsonValue>> members;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Ajoute this, écrit en JSON, à la fin de out.
+  void write(string& out) const;
+};
+
+#endif
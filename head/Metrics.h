@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This relève des compteurs et des chronomètres nommés, étape par étape.
+///
+/// Chaque mesure occupe une case, réservée à sa première utilisation. Les valeurs
+/// s'accumulent jusqu'à l'appel de endStep, qui les range dans une ligne du relevé
+/// et les remet à zéro. Le relevé s'exporte en CSV ou en JSON, une colonne par mesure.
+///
+/// Les mesures sont normalement posées par les macros ci-dessous, qui ne produisent
+/// aucun code si AIP_INSTRUMENT n'est pas défini ("make INSTRUMENT=1").
+///
+/// Les bibliothèques (analyse, simulation) ne font qu'ajouter des mesures; seul le programme
+/// qui les mène termine les étapes, quand aucun autre fil ne mesure. Un programme qui ne
+/// termine jamais d'étape, comme le serveur, n'accumule donc aucune ligne.
+///
+/// Voici un exemple :
+///
+/// void FireSimulator::nextStage() {
+///   AIP_TIMER("fire.step");                    // Durée de la portée.
+///   ...
+///   AIP_COUNT("fire.ignited", toAdd);          // Ajoute toAdd au compteur.
+/// }
+/// ...
+/// for (int t = 0; t < n; ++t) {
+///   f.nextStage();
+///   AIP_STEP();                                // Termine la ligne de l'étape (dans main).
+/// }
+/// AIP_EXPORT("metrics");                       // Écrit metrics.csv et metrics.json.
+///
+/// Les mesures peuvent être ajoutées depuis plusieurs fils d'exécution à la fois.
+////////////////////////////////////////////////////////////////////////////////
+class Metrics {
+
+public:
+
+  /// Nombre maximal de mesures distinctes.
+  static const int maxSlots = 64;
+
+  /// Retourne le relevé du programme.
+  static Metrics& global();
+
+  /// Réserve une case pour le compteur name et retourne son numéro.
+  /// Un même nom donne toujours le même numéro.
+  int counter(const string& name);
+
+  /// Réserve une case pour le chronomètre name et retourne son numéro.
+  int timer(const string& name);
+
+  /// Ajoute n à la case slot (des nanosecondes pour un chronomètre).
+  void add(int slot, long long n);
+
+  /// Range les valeurs courantes dans une nouvelle ligne du relevé et les remet à zéro.
+  /// Ne doit pas être appelée pendant que d'autres fils ajoutent des mesures.
+  void endStep();
+
+  /// Retourne le nombre de lignes du relevé.
+  int nbSteps() const;
+
+  /// Efface le relevé et les valeurs courantes. Les cases restent réservées.
+  void clear();
+
+  /// Écrit le relevé dans le fichier 'filename.csv' : une ligne par étape, une colonne par
+  /// mesure, les chronomètres en millisecondes.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writeCSV(const string& filename) const;
+
+  /// Écrit le relevé dans le fichier 'filename.json' : un objet par étape.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writeJSON(const string& filename) const;
+
+  /// Retourne le nombre d'allocations dynamiques faites par le programme depuis son début.
+  /// Vaut toujours 0 si AIP_INSTRUMENT n'est pas défini.
+  static long long allocations();
+
+private:
+
+  // Nom de chaque case réservée, et vrai pour un chronomètre.
+  vector <string> names;
+  vector <bool> isTimer;
+
+  // Les valeurs courantes de chaque case.
+  atomic <long long> values[maxSlots];
+
+  // Les lignes terminées du relevé, de la taille de names au moment de leur ajout.
+  vector <vector <long long>> steps;
+
+  // Nombre d'allocations au début de l'étape courante.
+  long long allocationsAtStep;
+
+  // Protège names, isTimer, steps et allocationsAtStep.
+  mutable mutex lock;
+
+  Metrics();
+
+  // Réserve ou retrouve la case name.
+  int slot(const string& name, bool timer);
+};
+
+/// Ajoute à un chronomètre du relevé la durée de sa propre vie.
+class ScopedTimer {
+
+public:
+
+  /// Démarre le chronomètre de la case slot.
+  explicit ScopedTimer(int slot) : slot(slot), start(chrono::steady_clock::now()) {}
+
+  /// Arrête le chronomètre.
+  ~ScopedTimer() {
+
+    Metrics::global().add(slot, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+  }
+
+private:
+
+  int slot;
+  chrono::steady_clock::time_point start;
+};
+
+#define AIP_CONCAT_(a, b) a##b
+#define AIP_CONCAT(a, b) AIP_CONCAT_(a, b)
+
+#ifdef AIP_INSTRUMENT
+
+/// Mesure la durée de la portée courante dans le chronomètre name.
+#define AIP_TIMER(name) \
+  static const int AIP_CONCAT(aipSlot, __LINE__) = Metrics::global().timer(name); \
+  ScopedTimer AIP_CONCAT(aipTimer, __LINE__)(AIP_CONCAT(aipSlot, __LINE__))
+
+/// Ajoute n au compteur name.
+#define AIP_COUNT(name, n) \
+  do { static const int aipSlot = Metrics::global().counter(name); Metrics::global().add(aipSlot, (n)); } while (0)
+
+/// Termine la ligne de l'étape courante.
+#define AIP_STEP() Metrics::global().endStep()
+
+/// Écrit le relevé dans 'filename.csv' et 'filename.json'.
+#define AIP_EXPORT(filename) \
+  do { Metrics::global().writeCSV(filename); Metrics::global().writeJSON(filename); } while (0)
+
+#else
+
+#define AIP_TIMER(name) do {} while (0)
+#define AIP_COUNT(name, n) do {} while (0)
+#define AIP_STEP() do {} while (0)
+#define AIP_EXPORT(filename) do {} while (0)
+
+#endif
+
+#endif
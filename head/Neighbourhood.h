@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NEIGHBOURHOOD_H
+#define NEIGHBOURHOOD_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+using namespace std;
+
+/// Décalage de ligne du n-ième voisin d'un pixel : les 4 premiers voisins touchent le
+/// pixel par un bord (haut, bas, gauche, droite), les 4 suivants par un coin.
+constexpr int neighbourRow(int n) {
+
+    return (n == 0 || n == 4 || n == 5) ? -1 : (n == 1 || n == 6 || n == 7) ? 1 : 0;
+}
+
+/// Décalage de colonne du n-ième voisin d'un pixel.
+constexpr int neighbourColumn(int n) {
+
+    return (n == 2 || n == 4 || n == 6) ? -1 : (n == 3 || n == 5 || n == 7) ? 1 : 0;
+}
+
+/// Décalage du numéro du n-ième voisin d'un pixel, dans une image de largeur w.
+constexpr int neighbourOffset(int n, int w) {
+
+    return neighbourRow(n) * w + neighbourColumn(n);
+}
+
+/// Bords de l'image touchés par un pixel, réunis en un masque.
+enum PixelBorder : uint8_t { TopBorder = 1, BottomBorder = 2, LeftBorder = 4, RightBorder = 8 };
+
+/// Retourne les bords qui privent un pixel de son n-ième voisin.
+constexpr uint8_t neighbourBorders(int n) {
+
+    return (neighbourRow(n) < 0 ? TopBorder : 0) | (neighbourRow(n) > 0 ? BottomBorder : 0) |
+           (neighbourColumn(n) < 0 ? LeftBorder : 0) | (neighbourColumn(n) > 0 ? RightBorder : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Les bords touchés par chaque pixel d'une image w*h, calculés une fois pour toutes.
+///
+/// Un parcours qui ne connaît que les numéros k de ses pixels (file d'attente, liste
+/// de feux...) trouve ainsi leurs voisins sans retrouver la ligne et la colonne de k,
+/// c'est-à-dire sans division : voir NeighbourLoop <C>::apply(k, borders[k], w, visit).
+////////////////////////////////////////////////////////////////////////////////
+class PixelBorders {
+
+public:
+
+    /// Calcule les bords des pixels d'une image w*h, le tableau étant alloué par memory.
+    PixelBorders(int w, int h, pmr::memory_resource* memory = pmr::get_default_resource())
+        : width(w), borders(w * h, 0, memory) {
+
+        for (int j = 0; j < w; ++j) {
+
+            borders[j] |= TopBorder;
+            borders[(h - 1) * w + j] |= BottomBorder;
+        }
+
+        for (int k = 0; k < w * h; k += w) {
+
+            borders[k] |= LeftBorder;
+            borders[k + w - 1] |= RightBorder;
+        }
+    }
+
+    /// Retourne la largeur de l'image.
+    int getWidth() const { return width; }
+
+    /// Retourne les bords touchés par le pixel numéro k.
+    uint8_t operator[](int k) const { return borders[k]; }
+
+private:
+
+    int width;
+
+    pmr::vector <uint8_t> borders;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Parcours des voisins d'un pixel, déroulé à la compilation.
+///
+/// Connectivity vaut 4 (voisins par un bord) ou 8 (voisins par un bord ou un coin).
+/// NeighbourLoop <C>::apply(i, j, w, h, visit) appelle visit(k) pour chaque voisin k
+/// du pixel (i, j) d'une image w*h, numéroté k = i*w + j. Les décalages étant des
+/// constantes, chaque voisin se réduit à un test de bord et une addition.
+///
+/// NeighbourLoop <C>::apply(k, borders, w, visit) fait de même à partir du seul numéro k
+/// du pixel et des bords qu'il touche (voir PixelBorders) : chaque voisin se réduit à un
+/// test de bit et une addition, sans division.
+///
+/// NeighbourLoop <C>::applyAt(k, j, w, size, visit) convient à un parcours qui garde la
+/// colonne j de chaque pixel k d'une image de size pixels : il appelle visit(n, jn) pour
+/// chaque voisin n, de colonne jn, sans table des bords ni division.
+////////////////////////////////////////////////////////////////////////////////
+template <int Connectivity, int N = 0>
+struct NeighbourLoop {
+
+    static_assert(Connectivity == 4 || Connectivity == 8, "connectivity must be 4 or 8");
+
+    template <class Visit>
+    static inline void apply(int i, int j, int w, int h, Visit& visit) {
+
+        const int di = neighbourRow(N);
+        const int dj = neighbourColumn(N);
+
+        // Les tests sur di et dj sont résolus à la compilation : seuls les bords utiles sont vérifiés.
+        if ((di >= 0 || i > 0) && (di <= 0 || i < h - 1) && (dj >= 0 || j > 0) && (dj <= 0 || j < w - 1)) {
+
+            visit((i + di) * w + (j + dj));
+        }
+
+        NeighbourLoop <Connectivity, N + 1>::apply(i, j, w, h, visit);
+    }
+
+    template <class Visit>
+    static inline void apply(int k, uint8_t borders, int w, Visit& visit) {
+
+        if (!(borders & neighbourBorders(N))) visit(k + neighbourOffset(N, w));
+
+        NeighbourLoop <Connectivity, N + 1>::apply(k, borders, w, visit);
+    }
+
+    template <class Visit>
+    static inline void applyAt(int k, int j, int w, int size, Visit& visit) {
+
+        const int di = neighbourRow(N);
+        const int dj = neighbourColumn(N);
+
+        // La ligne du pixel n'est pas connue : les bords du haut et du bas sont testés sur k.
+        if ((di >= 0 || k >= w) && (di <= 0 || k < size - w) && (dj >= 0 || j > 0) && (dj <= 0 || j < w - 1)) {
+
+            visit(k + neighbourOffset(N, w), j + dj);
+        }
+
+        NeighbourLoop <Connectivity, N + 1>::applyAt(k, j, w, size, visit);
+    }
+};
+
+// Fin du déroulement : tous les voisins ont été visités.
+template <int Connectivity>
+struct NeighbourLoop <Connectivity, Connectivity> {
+
+    template <class Visit>
+    static inline void apply(int, int, int, int, Visit&) {}
+
+    template <class Visit>
+    static inline void apply(int, uint8_t, int, Visit&) {}
+
+    template <class Visit>
+    static inline void applyAt(int, int, int, int, Visit&) {}
+};
+
+#endif
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/// Retourne le nombre de fils d'exécution à utiliser quand nbThreads vaut 0 ou moins :
+/// autant que de cœurs disponibles.
+inline int defaultThreadCount(int nbThreads) {
+
+    if (nbThreads > 0) return nbThreads;
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// Découpe l'intervalle [begin, end) en au plus nbThreads tranches contiguës de tailles
+/// égales et appelle f(debut, fin) sur chacune d'elles dans un fil d'exécution distinct.
+/// Le fil appelant traite la première tranche, puis attend la fin des autres.
+/// Si nbThreads vaut 0 ou moins, autant de fils que de cœurs sont utilisés.
+template <class Function>
+void parallelFor(int begin, int end, int nbThreads, Function f) {
+
+    long long n = end - begin;
+
+    if (n <= 0) return;
+
+    nbThreads = static_cast<int>(std::min<long long>(defaultThreadCount(nbThreads), n));
+
+    if (nbThreads == 1) {
+
+        f(begin, end);
+        return;
+    }
+
+    std::vector <std::thread> threads;
+
+    for (int t = 1; t < nbThreads; ++t) {
+
+        int from = begin + static_cast<int>(n * t / nbThreads);
+        int to = begin + static_cast<int>(n * (t + 1) / nbThreads);
+
+        threads.emplace_back(f, from, to);
+    }
+
+    f(begin, begin + static_cast<int>(n / nbThreads));
+
+    for (std::thread& th : threads) {
+
+        th.join();
+    }
+}
+
+#endif
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PIXEL_GRID_H
+#define PIXEL_GRID_H
+
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "Color.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Opérations communes aux images denses.
+///
+/// Ces fonctions acceptent toute image Img qui offre getWidth(), getHeight() et
+/// getPixel(i, j) : Image, FixedImage <W, H>... Elles sont générées pour chaque
+/// type d'image : avec FixedImage, les dimensions sont des constantes et les
+/// boucles sur les lignes sont déroulées par le compilateur, sans allocation.
+////////////////////////////////////////////////////////////////////////////////
+
+/// Écrit img dans le fichier 'filename.aip' (voir Image::writeAIP).
+/// Renvoie une exception runtime_error si une erreur survient.
+template <class Img>
+void writeAIPFile(const Img& img, const string& filename) {
+
+  ofstream file(filename + ".aip");
+
+  if (!file) throw runtime_error("error open file (write AIP)");
+
+  file << img.getWidth() << " " << img.getHeight() << "\n";
+
+  for (int i = 0; i < img.getHeight(); ++i) {
+
+    for (int j = 0; j < img.getWidth(); ++j) {
+
+      file << static_cast<char>('0' + img.getPixel(i, j).toInt());
+    }
+
+    file << "\n";
+  }
+
+  if (!file) throw runtime_error("error open file (write AIP)");
+}
+
+/// Écrit img dans le fichier 'filename.svg', chaque pixel étant un carré de côté pixelSize
+/// (voir Image::writeSVG).
+/// Renvoie une exception runtime_error si une erreur survient.
+template <class Img>
+void writeSVGFile(const Img& img, const string& filename, int pixelSize) {
+
+  assert(pixelSize > 0);
+
+  ofstream file(filename + ".svg");
+
+  if (!file) throw runtime_error("error open file (write SVG)");
+
+  file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+       << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << pixelSize * img.getWidth()
+       << "\" height=\"" << pixelSize * img.getHeight() << "\">\n";
+
+  for (int i = 0; i < img.getHeight(); ++i) {
+
+    for (int j = 0; j < img.getWidth(); ++j) {
+
+      file << "<rect width=\"" << pixelSize << "\" height=\"" << pixelSize
+           << "\" x=\"" << pixelSize * j << "\" y=\"" << pixelSize * i
+           << "\" fill=\"" << img.getPixel(i, j) << "\" />\n";
+    }
+  }
+
+  file << "</svg>\n";
+
+  if (!file) throw runtime_error("error open file (write SVG)");
+}
+
+// Retourne le représentant du pixel k. Les liens pointent toujours vers un pixel de numéro inférieur.
+inline int findZoneRoot(int* parent, int k) {
+
+  while (parent[k] != k) k = parent[k] = parent[parent[k]];
+
+  return k;
+}
+
+// Réunit les ensembles des pixels a et b, le plus petit représentant devenant celui de l'union.
+inline void uniteZones(int* parent, int a, int b) {
+
+  a = findZoneRoot(parent, a);
+  b = findZoneRoot(parent, b);
+
+  if (a < b) parent[b] = a;
+  else if (b < a) parent[a] = b;
+}
+
+/// Numérote les zones de img, formées par Connectivity (4 ou 8) voisins, comme Analyst::zoneIndex :
+/// labels[i*w + j] reçoit la zone du pixel (i, j), les zones étant numérotées dans l'ordre de
+/// leur premier pixel. Retourne le nombre de zones.
+/// labels doit pouvoir contenir w*h entiers; c'est la seule mémoire utilisée (union-find en place).
+template <int Connectivity, class Img>
+int labelZones(const Img& img, int* labels) {
+
+  static_assert(Connectivity == 4 || Connectivity == 8, "connectivity must be 4 or 8");
+
+  const int w = img.getWidth();
+  const int h = img.getHeight();
+
+  // Premier passage : chaque pixel est relié à ses voisins déjà vus (gauche et ligne du dessus).
+  for (int i = 0; i < h; ++i) {
+
+    for (int j = 0; j < w; ++j) {
+
+      int k = i * w + j;
+      Color c = img.getPixel(i, j);
+
+      labels[k] = k;
+
+      if (j > 0 && img.getPixel(i, j - 1) == c) uniteZones(labels, k, k - 1);
+
+      if (i > 0) {
+
+        if (img.getPixel(i - 1, j) == c) uniteZones(labels, k, k - w);
+
+        if (Connectivity == 8) {
+
+          if (j > 0 && img.getPixel(i - 1, j - 1) == c) uniteZones(labels, k, k - w - 1);
+          if (j < w - 1 && img.getPixel(i - 1, j + 1) == c) uniteZones(labels, k, k - w + 1);
+        }
+      }
+    }
+  }
+
+  // Second passage : le parent d'un pixel le précède et a déjà reçu son numéro de zone;
+  // un représentant ouvre une nouvelle zone.
+  int zones = 0;
+
+  for (int k = 0; k < w * h; ++k) {
+
+    labels[k] = (labels[k] == k) ? zones++ : labels[labels[k]];
+  }
+
+  return zones;
+}
+
+/// Comme labelZones <Connectivity>, la connexité (4 ou 8) étant choisie à l'exécution.
+template <class Img>
+int labelZones(const Img& img, int* labels, int connectivity = 4) {
+
+  assert(connectivity == 4 || connectivity == 8);
+
+  return (connectivity == 8) ? labelZones <8>(img, labels) : labelZones <4>(img, labels);
+}
+
+#endif
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef QUAD_IMAGE_H
+#define QUAD_IMAGE_H
+
+#include <cstdint>
+#include <vector>
+#include "Image.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est une image rectangulaire colorée, rangée dans un arbre quaternaire.
+///
+/// L'image est placée dans un carré dont le côté est une puissance de 2, découpé
+/// récursivement en quatre quarts tant qu'un bloc n'est pas d'une seule couleur.
+/// Les grands blocs uniformes (lacs, massifs forestiers...) n'occupent ainsi qu'une
+/// feuille : la mémoire suit la longueur des contours, pas la surface de l'image.
+///   - getPixel et setPixel descendent l'arbre en O(log n); setPixel regroupe aussitôt
+///     quatre feuilles devenues identiques;
+///   - fillRectangle ne visite que les blocs coupés par le bord du rectangle;
+///   - l'analyse des zones relie directement les feuilles voisines.
+///
+/// Voici un exemple :
+///
+/// QuadImage map(Image::readAIP("images/amazonie_0"));
+/// map.fillRectangle(0, 0, 9, 9, Color::Blue);
+/// int zones = map.nbZones();
+/// Image img = map.toImage();
+////////////////////////////////////////////////////////////////////////////////
+class QuadImage {
+
+public:
+
+  /// Crée une image de dimensions w*h pixels, de la couleur col (noire par défaut).
+  QuadImage(int w, int h, Color col = Color::Black);
+
+  /// Crée une image qui a le contenu de img.
+  explicit QuadImage(const Image& img);
+
+  /// Retourne une image dense qui a le contenu de this.
+  Image toImage() const;
+
+  /// Retourne la largeur (width) de this.
+  int getWidth() const;
+
+  /// Retourne la hauteur (height) de this.
+  int getHeight() const;
+
+  /// Retourne la couleur du pixel de la ligne i et de la colonne j.
+  /// Précondition : 0 <= i < height et 0 <= j < width.
+  Color getPixel(int i, int j) const;
+
+  /// Insère la couleur col dans le pixel de coordonnées (i,j).
+  /// Précondition : 0 <= i < height et 0 <= j < width.
+  void setPixel(int i, int j, Color col);
+
+  /// Remplit this de la couleur col.
+  void fill(Color col);
+
+  /// Remplit un rectangle, partie de this, de la couleur col.
+  /// (i1, j1) est le coin supérieur gauche.
+  /// (i2, j2) est le coin inférieur droit.
+  /// Précondition : (i1,j1) et (i2,j2) sont des coordonnées valides.
+  void fillRectangle(int i1, int j1, int i2, int j2, Color col);
+
+  /// Retourne le nombre de feuilles (blocs uniformes) de this, y compris celles hors de l'image.
+  int nbLeaves() const;
+
+  /// Retourne le nombre de nœuds de l'arbre.
+  int nbNodes() const;
+
+  /// Appelle visit(i, j, size, col) pour chaque bloc uniforme de l'image : le carré de size*size
+  /// pixels dont le coin supérieur gauche est (i, j) est de la couleur col.
+  template <class Visit>
+  void forEachBlock(Visit visit) const;
+
+  /// Retourne le nombre de pixels d'une couleur donnée.
+  int nbPixelsOfColor(Color c) const;
+
+  /// Retourne le nombre de zones de chaque couleur, indexé par Color::toInt(), pour des zones
+  /// formées par 4 ou 8 voisins (voir Analyst). Les feuilles voisines sont reliées sans
+  /// parcourir leurs pixels.
+  vector <int> zonesPerColor(int connectivity = 4) const;
+
+  /// Retourne le nombre de zones d'une couleur donnée.
+  int nbZonesOfColor(Color c, int connectivity = 4) const;
+
+  /// Retourne le nombre de zones de l'image.
+  int nbZones(int connectivity = 4) const;
+
+private:
+
+  // Un nœud : une feuille d'une seule couleur, ou quatre enfants rangés côte à côte dans
+  // nodes (haut gauche, haut droite, bas gauche, bas droite).
+  struct Node {
+
+    int child;     // Indice du premier enfant, -1 pour une feuille.
+    uint8_t color; // Couleur d'une feuille (Color::toInt()), ou outside.
+  };
+
+  // Couleur des feuilles qui dépassent de l'image.
+  static const uint8_t outside = 0xff;
+
+  int width, height;
+
+  // Côté du carré qui contient l'image.
+  int side;
+
+  // La racine est nodes[0].
+  vector <Node> nodes;
+
+  // Les groupes de quatre nœuds libérés, réutilisés par les découpes suivantes.
+  vector <int> freeBlocks;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Retourne l'indice d'un groupe de quatre feuilles de couleur color.
+  int allocateBlock(uint8_t color);
+
+  // Libère les descendants du nœud n, qui devient une feuille de couleur color.
+  void makeLeaf(int n, uint8_t color);
+
+  // Découpe la feuille n en quatre feuilles de sa couleur.
+  void split(int n);
+
+  // Regroupe les enfants du nœud n s'ils sont quatre feuilles de même couleur.
+  // Retourne vrai si n est devenu une feuille.
+  bool tryMerge(int n);
+
+  // Construit le nœud n pour le bloc de coin (i, j) et de côté size de img.
+  void build(int n, const Image& img, int i, int j, int size);
+
+  // Remplit la partie du rectangle qui coupe le bloc du nœud n, de coin (i, j) et de côté size.
+  void fillRect(int n, int i, int j, int size, int i1, int j1, int i2, int j2, uint8_t color);
+
+  // Appelle visit sur les feuilles du nœud n, de coin (i, j) et de côté size.
+  template <class Visit>
+  void visitLeaves(int n, int i, int j, int size, Visit& visit) const;
+
+  // Parcours des contacts entre feuilles pour l'analyse des zones (voir zonesPerColor).
+  template <class Link>
+  void cellContacts(int n, bool diagonals, Link& link) const;
+
+  template <class Link>
+  void horizontalContacts(int left, int right, bool diagonals, Link& link) const;
+
+  template <class Link>
+  void verticalContacts(int top, int bottom, bool diagonals, Link& link) const;
+
+  template <class Link>
+  void cornerContacts(int topLeft, int topRight, int bottomLeft, int bottomRight, Link& link) const;
+};
+
+template <class Visit>
+void QuadImage::visitLeaves(int n, int i, int j, int size, Visit& visit) const {
+
+  if (nodes[n].child == -1) {
+
+    if (nodes[n].color != outside) visit(i, j, size, Color::makeColor(nodes[n].color));
+
+    return;
+  }
+
+  int half = size / 2;
+  int c = nodes[n].child;
+
+  visitLeaves(c, i, j, half, visit);
+  visitLeaves(c + 1, i, j + half, half, visit);
+  visitLeaves(c + 2, i + half, j, half, visit);
+  visitLeaves(c + 3, i + half, j + half, half, visit);
+}
+
+template <class Visit>
+void QuadImage::forEachBlock(Visit visit) const {
+
+  visitLeaves(0, 0, 0, side, visit);
+}
+
+#endif
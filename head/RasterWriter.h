@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RASTER_WRITER_H
+#define RASTER_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Image.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This écrit des images sous forme de tableaux de pixels : PPM binaire ou PNG à
+/// palette (un octet par pixel).
+///
+/// Chaque couleur est traduite en rouge, vert et bleu par une palette, celle des
+/// couleurs SVG de writeSVG par défaut. Comme avec writeSVG, chaque pixel peut être
+/// agrandi en un carré de côté pixelSize. Le PNG n'est pas compressé (blocs deflate
+/// stockés tels quels) : il ne dépend d'aucune bibliothèque, et reste bien plus petit
+/// qu'un fichier SVG qui décrit chaque pixel par une ligne de texte.
+///
+/// Voici un exemple :
+///
+/// RasterWriter raster(4);
+/// raster.writePNG(img, "images/carte");                      // images/carte.png
+/// raster.writeSequence(f.runSimulator(1000), "png/image", RasterWriter::PNG);
+////////////////////////////////////////////////////////////////////////////////
+class RasterWriter {
+
+public:
+
+  /// Les formats d'écriture.
+  enum Format { PPM, PNG };
+
+  /// Prépare l'écriture de pixels agrandis en carrés de côté pixelSize, avec la palette par défaut.
+  explicit RasterWriter(int pixelSize = 1);
+
+  /// Donne à la couleur c le rouge red, le vert green et le bleu blue dans la palette.
+  void setColor(Color c, uint8_t red, uint8_t green, uint8_t blue);
+
+  /// Retourne le côté des carrés de pixels.
+  int getPixelSize() const;
+
+  /// Retourne le contenu du fichier PPM (P6) de img.
+  string encodePPM(const Image& img) const;
+
+  /// Retourne le contenu du fichier PNG de img.
+  string encodePNG(const Image& img) const;
+
+  /// Écrit img dans le fichier 'filename.ppm'.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writePPM(const Image& img, const string& filename) const;
+
+  /// Écrit img dans le fichier 'filename.png'.
+  /// Renvoie une exception runtime_error si une erreur survient.
+  void writePNG(const Image& img, const string& filename) const;
+
+  /// Écrit img dans le fichier 'filename.ppm' ou 'filename.png' selon format.
+  void write(const Image& img, const string& filename, Format format) const;
+
+  /// Écrit les images frames, par exemple celles de runSimulator, dans les fichiers
+  /// 'prefix0', 'prefix1'... suivis de l'extension du format. Chaque image est encodée
+  /// par une tâche d'un ThreadPool de nbThreads fils (autant que de cœurs si nbThreads vaut 0).
+  /// Renvoie la première exception levée par une écriture.
+  void writeSequence(const vector <Image>& frames, const string& prefix, Format format, int nbThreads = 0) const;
+
+  /// Retourne l'extension des fichiers du format, ".ppm" ou ".png".
+  static string extension(Format format);
+
+private:
+
+  int pixelSize;
+
+  // Rouge, vert et bleu de chaque couleur : 3 octets par identifiant de couleur.
+  vector <uint8_t> palette;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Écrit content dans le fichier name, format nommant le format dans le message d'erreur.
+  static void writeFile(const string& content, const string& name, const string& format);
+};
+
+#endif
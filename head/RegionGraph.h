@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef REGION_GRAPH_H
+#define REGION_GRAPH_H
+
+#include <utility>
+#include <vector>
+#include "Color.h"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est un graphe d'adjacence des zones d'une image.
+///
+/// Chaque sommet est une zone, numérotée de 0 à nbNodes()-1, et porte sa couleur.
+/// Chaque arête relie deux zones voisines et porte la longueur de leur frontière
+/// commune, c'est-à-dire le nombre de paires de pixels voisins qui les séparent.
+///
+/// Le graphe est stocké sous forme compacte (CSR) : les voisins de la zone z sont
+/// rangés par numéro croissant entre les positions offsets[z] et offsets[z+1].
+////////////////////////////////////////////////////////////////////////////////
+class RegionGraph {
+
+public:
+
+  /// Crée un graphe vide.
+  RegionGraph();
+
+  /// Crée le graphe des zones de couleurs colors à partir des contacts relevés entre
+  /// pixels voisins. Chaque contact est une paire de numéros de zones différentes et
+  /// compte pour une unité de frontière. Le tableau contacts est trié au passage.
+  RegionGraph(const vector <Color>& colors, vector <pair <int, int>>& contacts);
+
+  /// Retourne le nombre de zones (sommets) du graphe.
+  int nbNodes() const;
+
+  /// Retourne le nombre de paires de zones voisines (arêtes) du graphe.
+  int nbEdges() const;
+
+  /// Retourne la couleur de la zone z.
+  Color getColor(int z) const;
+
+  /// Retourne le nombre de zones voisines de la zone z.
+  int degree(int z) const;
+
+  /// Retourne le n-ième voisin de la zone z, avec 0 <= n < degree(z).
+  int neighbour(int z, int n) const;
+
+  /// Retourne la longueur de la frontière entre la zone z et son n-ième voisin.
+  int borderLength(int z, int n) const;
+
+  /// Retourne la longueur de la frontière commune aux zones z1 et z2, 0 si elles ne se touchent pas.
+  int sharedBorder(int z1, int z2) const;
+
+  /// Retourne vrai si les zones z1 et z2 sont voisines.
+  bool areAdjacent(int z1, int z2) const;
+
+private:
+
+  // La couleur de chaque zone.
+  vector <Color> nodeColor;
+
+  // Le début de la liste des voisins de chaque zone dans neighbours, suivi de la taille de neighbours.
+  vector <int> offsets;
+
+  // Les listes de voisins, mises bout à bout.
+  vector <int> neighbours;
+
+  // La longueur de frontière associée à chaque case de neighbours.
+  vector <int> lengths;
+};
+
+#endif
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TERRAIN_GENERATOR_H
+#define TERRAIN_GENERATOR_H
+
+#include "Image.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// Paramètres de génération d'un terrain synthétique.
+///
+/// Le terrain est tiré de deux bruits de valeurs fractals (plusieurs octaves de bruit
+/// interpolé) : un relief, dont les creux deviennent de l'eau (Color::Blue), et une
+/// densité de bâti, dont les sommets deviennent de la ville (Color::White). Le reste
+/// est de la forêt (Color::Green).
+///
+/// La taille des zones suit featureSize (côté typique, en pixels, des plus grandes
+/// zones) tandis que octaves et persistence règlent la quantité de petites zones le
+/// long des contours : peu d'octaves ou une faible persistance donnent des zones
+/// larges aux bords lisses, beaucoup d'octaves des bords découpés et de nombreux îlots.
+////////////////////////////////////////////////////////////////////////////////
+struct TerrainParameters {
+
+  /// Graine du générateur : une même graine donne toujours la même image,
+  /// quel que soit le nombre de fils d'exécution.
+  unsigned seed = 1;
+
+  /// Côté typique, en pixels, des lacs et des massifs forestiers.
+  int featureSize = 128;
+
+  /// Côté typique, en pixels, des zones urbaines.
+  int urbanFeatureSize = 32;
+
+  /// Nombre d'octaves de bruit superposées (au moins 1).
+  int octaves = 4;
+
+  /// Poids de chaque octave par rapport à la précédente, entre 0 et 1.
+  double persistence = 0.5;
+
+  /// Proportions visées de pixels d'eau et de ville, la forêt occupant le reste.
+  double waterRatio = 0.15;
+  double urbanRatio = 0.10;
+
+  /// Nombre de fils d'exécution, autant que de cœurs si 0.
+  int nbThreads = 0;
+};
+
+/// Génère un terrain de largeur w et de hauteur h selon les paramètres p.
+/// Les bandes de lignes de l'image sont remplies en parallèle.
+Image makeTerrainImage(int w, int h, const TerrainParameters& p = TerrainParameters());
+
+#endif
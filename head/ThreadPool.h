@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+/// This est un groupe de fils d'exécution qui se partagent des tâches par vol de travail.
+///
+/// Chaque fil possède sa propre file de tâches. Il prend d'abord la dernière tâche
+/// ajoutée à sa file, puis, si elle est vide, vole la plus ancienne tâche d'un autre
+/// fil. Une tâche soumise depuis un fil du groupe va dans la file de ce fil : elle
+/// sera traitée juste après, tant que ses données sont encore en mémoire.
+///
+/// Voici un exemple :
+///
+/// ThreadPool pool(4);
+/// for (const string& name : names) {
+///   pool.submit([&pool, name]() {
+///     auto img = make_shared <Image>(Image::readAIP(name)); // Lecture...
+///     pool.submit([img]() { Analyst a(*img); a.nbZones(); }); // ...puis analyse.
+///   });
+/// }
+/// pool.wait();
+////////////////////////////////////////////////////////////////////////////////
+class ThreadPool {
+
+public:
+
+  /// Démarre nbThreads fils d'exécution, ou autant que de cœurs si nbThreads vaut 0 ou moins.
+  explicit ThreadPool(int nbThreads = 0);
+
+  /// Attend la fin des tâches soumises, puis arrête les fils.
+  ~ThreadPool();
+
+  /// Interdit la copie de groupes de fils.
+  ThreadPool(const ThreadPool&) = delete;
+
+  /// Interdit l'affectation de groupes de fils.
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Ajoute une tâche. Peut être appelée depuis une tâche.
+  void submit(function <void()> task);
+
+  /// Attend que toutes les tâches soumises, y compris celles soumises par d'autres tâches,
+  /// soient terminées. Si une tâche a levé une exception, la première est relancée ici.
+  /// Ne doit pas être appelée depuis une tâche.
+  void wait();
+
+  /// Retourne le nombre de fils du groupe.
+  int size() const;
+
+private:
+
+  // La file de tâches d'un fil, protégée par son propre verrou.
+  struct Worker {
+
+    deque <function <void()>> tasks;
+    mutex lock;
+  };
+
+  vector <unique_ptr <Worker>> workers;
+  vector <thread> threads;
+
+  // Nombre de tâches en file, et de tâches soumises mais pas encore terminées.
+  atomic <int> queued;
+  atomic <int> pending;
+
+  // File suivante pour une tâche soumise hors du groupe.
+  atomic <unsigned> nextWorker;
+
+  atomic <bool> stopping;
+
+  // Réveil des fils en attente de tâches, et de wait.
+  mutex sleepLock;
+  condition_variable wakeUp;
+  condition_variable allDone;
+
+  // Première exception levée par une tâche.
+  exception_ptr failure;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Boucle du fil numéro w.
+  void run(int w);
+
+  // Retire une tâche de la file du fil w, ou à défaut la vole dans une autre file.
+  bool take(int w, function <void()>& task);
+};
+
+#endif
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ZONE_TRACKER_H
+#define ZONE_TRACKER_H
+
+#include <vector>
+#include "Image.h"
+#include "Neighbourhood.h"
+
+using namespace std;
+
+/// Une zone coupée en plusieurs morceaux.
+struct ZoneSplit {
+
+  /// La zone d'origine, qui garde son identifiant pour son plus grand morceau.
+  int parent;
+
+  /// Les identifiants des nouveaux morceaux.
+  vector <int> children;
+};
+
+/// Des zones réunies en une seule.
+struct ZoneMerge {
+
+  /// La zone qui subsiste, la plus grande.
+  int survivor;
+
+  /// Les zones absorbées, qui disparaissent.
+  vector <int> absorbed;
+};
+
+/// Le changement de taille d'une zone, en pixels.
+struct AreaChange {
+
+  int zone;
+  int before;
+  int after;
+};
+
+/// Les évolutions des zones entre deux images d'une suite.
+struct TrackingStep {
+
+  /// Nombre de pixels qui ont changé de couleur.
+  int changedPixels;
+
+  /// Les zones apparues et celles dont tous les pixels ont changé de couleur.
+  vector <int> births;
+  vector <int> deaths;
+
+  vector <ZoneSplit> splits;
+  vector <ZoneMerge> merges;
+
+  /// Les zones présentes avant et après l'étape dont la taille a changé.
+  vector <AreaChange> areaChanges;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// This suit les zones d'une suite d'images de mêmes dimensions (étapes d'une
+/// simulation, passages successifs au-dessus d'une même région).
+///
+/// Chaque zone reçoit un identifiant qui ne change pas d'une image à l'autre tant
+/// qu'elle existe; un identifiant n'est jamais réutilisé. À chaque nouvelle image,
+/// seuls les pixels qui ont changé de couleur et leur voisinage sont réétiquetés :
+///   - une zone qui perd des pixels n'est parcourue qu'à partir des bords de la perte,
+///     par des parcours menés de front qui s'arrêtent dès qu'ils se rejoignent; seuls
+///     les morceaux détachés sont parcourus en entier;
+///   - des zones réunies par de nouveaux pixels gardent l'identifiant de la plus grande,
+///     seules les plus petites sont réétiquetées.
+/// Le coût d'une étape suit donc la surface qui change, et non la taille de l'image.
+///
+/// Voici un exemple :
+///
+/// ZoneTracker tracker(f.getImage());
+/// for (int t = 1; t <= n; ++t) {
+///   f.nextStage();
+///   TrackingStep s = tracker.update(f.getImage());
+///   for (const ZoneSplit& split : s.splits) { ... }
+/// }
+////////////////////////////////////////////////////////////////////////////////
+class ZoneTracker {
+
+public:
+
+  /// Analyse la première image de la suite. Ses zones reçoivent les identifiants de
+  /// 0 à nbZones()-1 (voir Analyst::zoneIndex). connectivity vaut 4 ou 8.
+  ZoneTracker(const Image& img, int connectivity = 4);
+
+  /// Passe à l'image suivante et retourne les évolutions des zones.
+  /// Précondition : img a les dimensions de la première image.
+  TrackingStep update(const Image& img);
+
+  /// Comme update(img), lorsque les pixels qui ont pu changer sont déjà connus (par exemple
+  /// les pixels allumés ou éteints par le simulateur) : l'image n'est pas comparée en entier.
+  /// Précondition : tous les pixels qui ont changé de couleur sont dans candidates.
+  TrackingStep update(const Image& img, const vector <int>& candidates);
+
+  /// Retourne l'identifiant de la zone du pixel de coordonnées (i, j).
+  int zoneOf(int i, int j) const;
+
+  /// Retourne l'identifiant de la zone de chaque pixel, le pixel (i, j) étant rangé à la case i*w + j.
+  const vector <int>& getLabels() const;
+
+  /// Retourne le nombre de zones de l'image courante.
+  int nbZones() const;
+
+  /// Retourne le nombre d'identifiants attribués depuis le début de la suite.
+  int nbIds() const;
+
+  /// Retourne vrai si la zone id existe dans l'image courante.
+  bool isAlive(int id) const;
+
+  /// Retourne la couleur de la zone id.
+  Color zoneColor(int id) const;
+
+  /// Retourne le nombre de pixels de la zone id, 0 si elle a disparu.
+  int zoneArea(int id) const;
+
+  /// Retourne la connexité du suivi, 4 ou 8.
+  int getConnectivity() const;
+
+private:
+
+  int width, height;
+
+  int connectivity;
+
+  // L'image courante, comparée à la suivante par Image::changedPixels.
+  Image frame;
+
+  // Les bords touchés par chaque pixel, pour parcourir les voisins sans division.
+  PixelBorders borders;
+
+  // L'identifiant de zone de chaque pixel; négatif pendant une mise à jour pour les pixels
+  // en cours de réétiquetage.
+  vector <int> labels;
+
+  // La couleur et la taille de chaque zone, indexées par identifiant. Une zone disparue a une taille nulle.
+  vector <Color> zoneColors;
+  vector <int> zoneAreas;
+
+  // Le nombre de zones de taille non nulle.
+  int alive;
+
+  // Parcours de la zone d'un pixel : owner[k] est le parcours qui a atteint le pixel k, -1 sinon.
+  // Remis à -1 après chaque recherche de coupure.
+  vector <int> owner;
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  // Appelle visit(n) pour chaque voisin n du pixel k.
+  template <class Visit>
+  void forEachNeighbour(int k, Visit visit) const;
+
+  // Crée une zone de couleur c et retourne son identifiant.
+  int newZone(Color c);
+
+  // Cherche si la zone id, qui a perdu des pixels voisins de seeds, a été coupée. Les morceaux
+  // détachés reçoivent de nouveaux identifiants, ajoutés à children.
+  void splitZone(int id, vector <int>& seeds, vector <int>& children);
+
+  // Donne l'identifiant to à tous les pixels de la zone du pixel k, d'identifiant from.
+  void relabel(int k, int from, int to);
+
+  // Met à jour les zones après le changement de couleur des pixels de changed.
+  TrackingStep apply(const vector <int>& changed);
+};
+
+#endif
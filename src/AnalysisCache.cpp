@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "../head/Analyst.h"
+#include "../head/AnalysisCache.h"
+
+// Les fichiers du dossier de cache commencent par ces 4 octets, suivis du numéro de version du format.
+static const char cacheMagic[4] = { 'A', 'I', 'P', 'A' };
+static const uint32_t cacheVersion = 3;
+
+AnalysisCache::AnalysisCache(size_t capacity, const string& directory, int connectivity) {
+
+    assert(capacity >= 1);
+    assert(connectivity == 4 || connectivity == 8);
+
+    this->capacity = capacity;
+    this->directory = directory;
+    this->connectivity = connectivity;
+    hits = 0;
+    misses = 0;
+}
+
+bool AnalysisCache::Key::operator==(const Key& k) const {
+
+    return hash == k.hash && check == k.check && width == k.width && height == k.height;
+}
+
+AnalysisCache::Key AnalysisCache::keyOf(const Image& img) {
+
+    Key key;
+
+    key.hash = img.hash();
+    key.width = img.getWidth();
+    key.height = img.getHeight();
+
+    // Seconde empreinte, FNV-1a sur un octet par pixel : deux images distinctes de même
+    // Image::hash n'ont pratiquement aucune chance d'avoir aussi la même.
+    key.check = 14695981039346656037ull;
+
+    img.forEachPixel([&key](int, Color c) {
+
+        key.check = (key.check ^ static_cast<uint64_t>(c.toInt())) * 1099511628211ull;
+    });
+
+    return key;
+}
+
+shared_ptr <const AnalysisResult> AnalysisCache::analyse(const Image& img) {
+
+    Key key = keyOf(img);
+
+    shared_ptr <const AnalysisResult> r = find(key);
+
+    if (r) return r;
+
+    // Le verrou n'est pas gardé pendant la lecture ou l'analyse : d'autres fils peuvent
+    // interroger le cache pendant ce temps.
+    if (!directory.empty()) {
+
+        r = load(key);
+
+        if (r) {
+
+            insert(key, r, true);
+            return r;
+        }
+    }
+
+    Analyst a(img, false, connectivity);
+    r = make_shared <const AnalysisResult>(a.getResult());
+
+    // Un dossier inaccessible ne fait que priver les exécutions suivantes de ce résultat.
+    if (!directory.empty()) {
+
+        save(key, *r);
+    }
+
+    insert(key, r, false);
+
+    return r;
+}
+
+shared_ptr <const AnalysisResult> AnalysisCache::find(const Key& key) {
+
+    lock_guard <mutex> guard(lock);
+
+    unordered_map <uint64_t, list <Entry>::iterator>::iterator it = index.find(key.hash);
+
+    // Une même empreinte ne suffit pas : le résultat doit être celui d'une image identique.
+    if (it == index.end() || !(it->second->first == key)) return nullptr;
+
+    // Le résultat devient le plus récemment utilisé.
+    entries.splice(entries.begin(), entries, it->second);
+    ++hits;
+
+    return it->second->second;
+}
+
+void AnalysisCache::insert(const Key& key, const shared_ptr <const AnalysisResult>& r, bool loaded) {
+
+    lock_guard <mutex> guard(lock);
+
+    if (loaded) ++hits;
+
+    else ++misses;
+
+    unordered_map <uint64_t, list <Entry>::iterator>::iterator it = index.find(key.hash);
+
+    if (it != index.end()) {
+
+        // Un autre fil a pu ajouter le même résultat entre-temps.
+        if (it->second->first == key) return;
+
+        // Une autre image de même empreinte : le résultat le plus récent la remplace.
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.push_front(Entry(key, r));
+    index[key.hash] = entries.begin();
+
+    if (entries.size() > capacity) {
+
+        index.erase(entries.back().first.hash);
+        entries.pop_back();
+    }
+}
+
+size_t AnalysisCache::size() const {
+
+    lock_guard <mutex> guard(lock);
+
+    return entries.size();
+}
+
+size_t AnalysisCache::nbHits() const {
+
+    lock_guard <mutex> guard(lock);
+
+    return hits;
+}
+
+size_t AnalysisCache::nbMisses() const {
+
+    lock_guard <mutex> guard(lock);
+
+    return misses;
+}
+
+void AnalysisCache::clear() {
+
+    lock_guard <mutex> guard(lock);
+
+    entries.clear();
+    index.clear();
+}
+
+string AnalysisCache::filename(uint64_t h) const {
+
+    char name[20];
+
+    // Le voisinage fait partie du nom : une même image a un fichier par voisinage.
+    snprintf(name, sizeof(name), "%016llx-%d", static_cast<unsigned long long>(h), connectivity);
+
+    return directory + "/" + name + ".aia";
+}
+
+// Format d'un fichier du cache, en binaire :
+//   - les 4 octets "AIPA" puis la version du format (32 bits);
+//   - l'empreinte de l'image puis sa seconde empreinte (64 bits chacune);
+//   - la largeur, la hauteur, le nombre de zones et le voisinage (32 bits chacun);
+//   - la couleur de chaque zone (un octet par zone);
+//   - la zone de chaque pixel (32 bits par pixel).
+// La table des zones et les comptages sont recalculés à la lecture.
+shared_ptr <const AnalysisResult> AnalysisCache::load(const Key& key) const {
+
+    int w = key.width;
+    int hgt = key.height;
+
+    ifstream file(filename(key.hash), ios::binary);
+
+    if (!file) return nullptr;
+
+    char magic[4];
+    uint32_t version;
+    uint64_t fileHash, fileCheck;
+    int32_t header[4];
+
+    file.read(magic, 4);
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+    file.read(reinterpret_cast<char*>(&fileCheck), sizeof(fileCheck));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+    // Un fichier illisible ou d'une autre image est ignoré : le résultat sera recalculé.
+    if (!file || memcmp(magic, cacheMagic, 4) != 0 || version != cacheVersion) return nullptr;
+    if (fileHash != key.hash || fileCheck != key.check || header[0] != w || header[1] != hgt || header[2] < 1) return nullptr;
+    if (header[3] != connectivity) return nullptr;
+
+    shared_ptr <AnalysisResult> r = make_shared <AnalysisResult>();
+
+    r->width = w;
+    r->height = hgt;
+    r->connectivity = connectivity;
+
+    vector <uint8_t> colors(header[2]);
+    file.read(reinterpret_cast<char*>(colors.data()), colors.size());
+
+    r->labels.resize(w * hgt);
+    file.read(reinterpret_cast<char*>(r->labels.data()), r->labels.size() * sizeof(int));
+
+    if (!file) return nullptr;
+
+    for (uint8_t c : colors) {
+
+        if (c >= Color::nbColors()) return nullptr;
+
+        r->zoneColors.push_back(Color::makeColor(c));
+    }
+
+    for (int l : r->labels) {
+
+        if (l < 0 || l >= header[2]) return nullptr;
+    }
+
+    r->complete();
+
+    return r;
+}
+
+bool AnalysisCache::save(const Key& key, const AnalysisResult& r) const {
+
+    // Le fichier est écrit sous un nom propre à ce processus et à cet appel, puis renommé d'un
+    // coup : un autre processus qui lit le cache ne voit jamais un fichier à moitié écrit.
+    static atomic <unsigned> nextTemporary(0);
+
+    string name = filename(key.hash);
+    string temporary = name + "." + to_string(getpid()) + "-" + to_string(nextTemporary++) + ".tmp";
+
+    int32_t header[4] = { r.width, r.height, r.nbZones(), r.connectivity };
+
+    vector <uint8_t> colors;
+
+    for (Color c : r.zoneColors) {
+
+        colors.push_back(c.toInt());
+    }
+
+    {
+        ofstream file(temporary, ios::binary);
+
+        if (!file) return false;
+
+        file.write(cacheMagic, 4);
+        file.write(reinterpret_cast<const char*>(&cacheVersion), sizeof(cacheVersion));
+        file.write(reinterpret_cast<const char*>(&key.hash), sizeof(key.hash));
+        file.write(reinterpret_cast<const char*>(&key.check), sizeof(key.check));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(colors.data()), colors.size());
+        file.write(reinterpret_cast<const char*>(r.labels.data()), r.labels.size() * sizeof(int));
+        file.close();
+
+        if (!file) {
+
+            remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    if (rename(temporary.c_str(), name.c_str()) != 0) {
+
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include "../head/AnalysisResult.h"
+
+int AnalysisResult::nbZones() const {
+
+    return zoneColors.size();
+}
+
+int AnalysisResult::zoneSize(int z) const {
+
+    assert(z >= 0 && z < nbZones());
+
+    return zoneOffsets[z+1] - zoneOffsets[z];
+}
+
+void AnalysisResult::complete() {
+
+    int n = labels.size();
+    int z = nbZones();
+
+    // Tri par dénombrement des pixels selon leur zone : on compte d'abord la taille de chaque zone.
+    zoneOffsets.assign(z + 1, 0);
+
+    for (int k = 0; k < n; ++k) {
+
+        ++zoneOffsets[labels[k] + 1];
+    }
+
+    for (int l = 0; l < z; ++l) {
+
+        zoneOffsets[l+1] += zoneOffsets[l];
+    }
+
+    // Chaque pixel est ensuite rangé dans sa zone, par numéro croissant.
+    zonePixels.resize(n);
+
+    vector <int> next(zoneOffsets.begin(), zoneOffsets.end() - 1);
+
+    for (int k = 0; k < n; ++k) {
+
+        zonePixels[next[labels[k]]++] = k;
+    }
+
+    pixelsPerColor.assign(Color::nbColors(), 0);
+    zonesPerColor.assign(Color::nbColors(), 0);
+
+    for (int l = 0; l < z; ++l) {
+
+        pixelsPerColor[zoneColors[l].toInt()] += zoneSize(l);
+        ++zonesPerColor[zoneColors[l].toInt()];
+    }
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include "../head/Analyst.h"
+#include "../head/AnalysisSnapshot.h"
+
+AnalysisSnapshot::AnalysisSnapshot(shared_ptr <const Image> img, int connectivity) {
+
+    assert(img);
+
+    // L'analyse est faite une fois pour toutes, avant que this ne soit partagé.
+    Analyst a(*img, false, connectivity);
+
+    this->img = img;
+    result = make_shared <const AnalysisResult>(a.getResult());
+}
+
+AnalysisSnapshot::AnalysisSnapshot(shared_ptr <const Image> img, shared_ptr <const AnalysisResult> result) {
+
+    assert(img && result);
+    assert(result->width == img->getWidth() && result->height == img->getHeight());
+
+    this->img = img;
+    this->result = result;
+}
+
+const Image& AnalysisSnapshot::getImage() const {
+
+    return *img;
+}
+
+const AnalysisResult& AnalysisSnapshot::getResult() const {
+
+    return *result;
+}
+
+bool AnalysisSnapshot::belongToTheSameZone(int i1, int j1, int i2, int j2) const {
+
+    return zoneIndex(i1, j1) == zoneIndex(i2, j2);
+}
+
+int AnalysisSnapshot::nbPixelsOfColor(Color c) const {
+
+    return result->pixelsPerColor[c.toInt()];
+}
+
+int AnalysisSnapshot::nbZonesOfColor(Color c) const {
+
+    return result->zonesPerColor[c.toInt()];
+}
+
+int AnalysisSnapshot::nbZones() const {
+
+    return result->nbZones();
+}
+
+int AnalysisSnapshot::zoneIndex(int i, int j) const {
+
+    return result->labels[img->toIndex(i, j)];
+}
+
+int AnalysisSnapshot::zoneSize(int z) const {
+
+    return result->zoneSize(z);
+}
+
+Color AnalysisSnapshot::zoneColor(int z) const {
+
+    assert(z >= 0 && z < nbZones());
+
+    return result->zoneColors[z];
+}
+
+set <int> AnalysisSnapshot::zoneOfPixel(int i, int j) const {
+
+    int z = zoneIndex(i, j);
+
+    // Les pixels de la zone sont déjà triés dans la table des zones : l'insertion se fait en fin d'ensemble.
+    vector <int>::const_iterator first = result->zonePixels.begin() + result->zoneOffsets[z];
+    vector <int>::const_iterator last = result->zonePixels.begin() + result->zoneOffsets[z+1];
+
+    return set <int>(first, last);
+}
+
+Image AnalysisSnapshot::fillZone(int i, int j, Color c) const {
+
+    Image copy(*img);
+
+    int z = zoneIndex(i, j);
+
+    if (result->zoneColors[z] == c) return copy;
+
+    for (int n = result->zoneOffsets[z]; n < result->zoneOffsets[z+1]; ++n) {
+
+        copy.setPixel(result->zonePixels[n], c);
+    }
+
+    return copy;
+}
@@ -7,23 +7,27 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cassert>
+#include "../head/Metrics.h"
+#include "../head/Neighbourhood.h"
 #include "../head/Analyst.h"
 
-Analyst::Analyst(const Image& img) {
+Analyst::Analyst(const Image& img, bool withGraph, int connectivity, pmr::memory_resource* memory)
+    : part(memory), lists(memory), zoneIds(memory) {
 
+    assert(connectivity == 4 || connectivity == 8);
+
+    this->withGraph = withGraph;
+    this->connectivity = connectivity;
     nbElem = img.getSize();
     zones = nbElem; // Il y a, au départ, autant de parties que de pixels.
     pImg = &img;
-    pixelsPerColor = initZero();
-    zonesPerColor = pixelsPerColor; // Toutes les couleurs ont 0 pixel dans la partition à ce stade.
-    
-    initPart();
 
-    UnionZones();
+    // Aucun calcul n'est fait ici : histogramme et partition attendent la première question qui en a besoin.
 }
 
 Analyst::~Analyst() {
 
+    // Les listes de la partition appartiennent à lists et sont libérées avec elle.
     pixelsPerColor.clear();
     zonesPerColor.clear();
     part.clear(); // Le vecteur est vidé de ses éléments mais prend toujours de la place en mémoire !
@@ -37,7 +41,7 @@ Analyst::~Analyst() {
     delete pImg;
 }
 
-vector <int> Analyst::initZero() {
+vector <int> Analyst::initZero() const {
 
     vector <int> v;
 
@@ -53,62 +57,125 @@ vector <int> Analyst::initZero() {
     return v;
 }
 
-void Analyst::initPart() {
+void Analyst::requireHistogram() const {
+
+    if (!pixelsPerColor.empty()) return;
+
+    pixelsPerColor = initZero();
+
+    pImg->forEachPixel([this](int, Color col) { ++pixelsPerColor[col.toInt()]; });
+}
+
+bool Analyst::isPartitioned() const {
+
+    return !part.empty();
+}
+
+void Analyst::requirePartition() const {
+
+    if (isPartitioned()) return;
+
+    initPart();
+
+    if (connectivity == 8) UnionZones<8>();
+
+    else UnionZones<4>();
+
+    if (withGraph) {
+
+        buildRegionGraph();
+    }
+
+    AIP_COUNT("analyst.pixels", nbElem);
+    AIP_COUNT("analyst.zones", zones);
+}
+
+void Analyst::initPart() const {
+
+    AIP_TIMER("analyst.initPart");
+
+    // L'histogramme est calculé au passage s'il ne l'a pas déjà été.
+    bool countPixels = pixelsPerColor.empty();
+
+    if (countPixels) {
+
+        pixelsPerColor = initZero();
+    }
 
     part.resize(nbElem);
+    lists.resize(nbElem); // Les listes reçoivent la ressource mémoire de lists.
 
     for (int k = 0; k < nbElem; ++k) {
 
-        part[k] = new list <int>;
+        part[k] = &lists[k];
 
         part[k]->push_front(k); // Chaque liste chaînée, à sa position k, contient l'unique élément k.
 
-        int i = pImg->toCoordinate(k).first;
-        int j = pImg->toCoordinate(k).second;
+        if (countPixels) {
 
-        Color col = pImg->getPixel(i, j); // On obtient la couleur du pixel k de coordonnées (i,j).
-
-        ++pixelsPerColor[col.toInt()];
-        ++zonesPerColor[col.toInt()]; // Il y a, à ce stade, autant de parties d'une couleur que de pixels de cette couleur.
+            ++pixelsPerColor[pImg->getPixel(k).toInt()];
+        }
     }
+
+    // Il y a, à ce stade, autant de parties d'une couleur que de pixels de cette couleur.
+    zonesPerColor = pixelsPerColor;
 }
 
-void Analyst::UnionZones() {
+// Chaque paire de voisins n'est examinée qu'une fois : depuis le pixel k de coordonnées (i,j), seuls
+// les voisins situés après lui (à droite et en dessous) sont considérés. Les bords sont vérifiés
+// ici, une fois par pixel : les voisins sont désignés par leur numéro, sans calcul de coordonnées.
+template <int Connectivity>
+void Analyst::UnionZones() const {
+
+    AIP_TIMER("analyst.unionZones");
+
+    int w = pImg->getWidth();
+    int h = pImg->getHeight();
 
-    for (int i = 0; i < pImg->getHeight(); ++i) {
+    for (int i = 0, k = 0; i < h; ++i) {
 
-        for (int j = 0; j < pImg->getWidth(); ++j) {
+        for (int j = 0; j < w; ++j, ++k) {
 
-            Union(i, j, i+1, j); // Fusionne le pixel de coordonnées (i,j) et son voisin de droite si nécessaire.
-            Union(i, j, i, j+1); // Fusionne le pixel de coordonnées (i,j) et son voisin du dessous si nécessaire.
+            if (i + 1 < h) UnionPixels(k, k + w); // Fusionne le pixel k et son voisin du dessous si nécessaire.
+            if (j + 1 < w) UnionPixels(k, k + 1); // Fusionne le pixel k et son voisin de droite si nécessaire.
+
+            // Condition résolue à la compilation : la 4-connexité n'examine pas les diagonales.
+            if (Connectivity == 8 && i + 1 < h) {
+
+                if (j > 0) UnionPixels(k, k + w - 1);     // Voisin en bas à gauche.
+                if (j + 1 < w) UnionPixels(k, k + w + 1); // Voisin en bas à droite.
+            }
         }
     }
 }
 
-void Analyst::Union(int i1, int j1, int i2, int j2) {
+void Analyst::UnionPixels(int k1, int k2) const {
 
-    // Les pixels sont voisins, appartiennent tous deux à l'image et à des zones différentes.
-    if (pImg->areConsecutivePixels(i1, j1, i2, j2) && !belongToTheSameZone(i1, i2, j1, j2)) {
+    // Les pixels appartiennent à des zones différentes.
+    if (Find(k1) != Find(k2)) {
 
-        Color col = pImg->getPixel(i1, j1);
-        Color col2 = pImg->getPixel(i2, j2);
+        Color col = pImg->getPixel(k1);
+        Color col2 = pImg->getPixel(k2);
 
         // Les pixels sont de même couleur.
         if (col == col2) {
 
-            int k1 = pImg->toIndex(i1, j1);
-            int k2 = pImg->toIndex(i2, j2);
-
             Union(k1, k2); // Fusion de la liste contenant l'élément k1 et de celle contenant k2.
 
             // La fusion de deux parties entraîne la décrémentation du nombre de parties.
             --zones;
             --zonesPerColor[col.toInt()];
         }
+
+        // Les pixels sont de couleurs différentes : leurs zones se touchent.
+        else if (withGraph) {
+
+            contacts.push_back(make_pair(k1, k2));
+        }
     }
 }
 
-void Analyst::Union(int i, int j) {
+void Analyst::Union(int i, int j) const {
 
     // Pour des raisons d'optimisation, on insère toujours la liste la plus petite dans la liste la plus grande.
     if (part[i]->size() < part[j]->size()) {
@@ -116,28 +183,34 @@ void Analyst::Union(int i, int j) {
         return Union(j, i);
     }
 
-    // La liste contenant j est détruite après avoir été vidée de ses éléments au début de la liste contenant i. 
-    list <int>::iterator it = part[i]->begin();
+    // La liste contenant j est vidée de ses éléments au début de la liste contenant i. Les deux listes
+    // partagent la ressource mémoire de lists : les nœuds sont déplacés sans être réalloués.
+    pmr::list <int>::iterator it = part[i]->begin();
     part[i]->splice(it, *part[j]);
 
     // Chaque élément de l'ancienne liste contenant j pointe désormais sur la liste contenant i.
-    for (list <int>::iterator jt = part[i]->begin(); jt != it; ++jt) {
+    for (pmr::list <int>::iterator jt = part[i]->begin(); jt != it; ++jt) {
 
         part[*jt] = part[i];
     }
 }
 
-int Analyst::Find(const int i, const int j) {
+int Analyst::Find(const int i, const int j) const {
 
     return Find(pImg->toIndex(i,j));
 }
 
-int Analyst::Find(const int k) {
+int Analyst::Find(const int k) const {
 
     return part[k]->front(); // Le représentant du pixel k est le premier élément de la liste le contenant.
 }
 
-bool Analyst::belongToTheSameZone(int i1, int i2, int j1, int j2) {
+bool Analyst::belongToTheSameZone(int i1, int j1, int i2, int j2) {
+
+    // Deux pixels de couleurs différentes ne peuvent appartenir à la même zone : inutile de construire la partition.
+    if (pImg->getPixel(i1, j1) != pImg->getPixel(i2, j2)) return false;
+
+    requirePartition();
 
     // Deux pixels de même zone font partie de la même liste, et ont donc le même représentant (premier élément).
     return Find(i1, j1) == Find(i2, j2);
@@ -145,19 +218,61 @@ bool Analyst::belongToTheSameZone(int i1, int i2, int j1, int j2) {
 
 int Analyst::nbZones() const {
 
+    requirePartition();
+
     return zones;
 }
 
 int Analyst::nbPixelsOfColor(Color col) const {
 
+    requireHistogram();
+
     return pixelsPerColor[col.toInt()];
 }
 
 int Analyst::nbZonesOfColor(Color col) const {
 
+    requirePartition();
+
     return zonesPerColor[col.toInt()];
 }
 
+template <int Connectivity, class Visit, class IsVisited>
+void Analyst::floodZone(int i, int j, Visit visit, IsVisited isVisited) const {
+
+    Color col = pImg->getPixel(i, j);
+    int w = pImg->getWidth();
+    int size = pImg->getSize();
+
+    // Pile des pixels de la zone rencontrés mais dont les voisins restent à examiner, chacun
+    // avec sa colonne : les bords de l'image sont testés sans retrouver les coordonnées du pixel.
+    vector <pair <int, int>> stack;
+
+    int k = pImg->toIndex(i, j);
+
+    visit(k);
+    stack.push_back(make_pair(k, j));
+
+    while (!stack.empty()) {
+
+        k = stack.back().first;
+        j = stack.back().second;
+        stack.pop_back();
+
+        // Les voisins du pixel de même couleur, pas encore rencontrés, sont ajoutés à la zone.
+        auto expand = [this, &stack, &visit, &isVisited, col](int n, int jn) {
+
+            if (!isVisited(n) && pImg->getPixel(n) == col) {
+
+                visit(n);
+                stack.push_back(make_pair(n, jn));
+            }
+        };
+
+        NeighbourLoop <Connectivity>::applyAt(k, j, w, size, expand);
+    }
+}
+
 Image Analyst::fillZone(int i, int j, Color col) {
 
     // Rien n'est à faire dans le cas où la zone est déjà de la bonne couleur.
@@ -171,30 +286,310 @@ Image Analyst::fillZone(int i, int j, Color col) {
 
     int k = img.toIndex(i, j);
 
+    // Sans partition, la zone est remplie de proche en proche : un pixel déjà repeint
+    // de la couleur col est un pixel déjà rencontré.
+    if (!isPartitioned()) {
+
+        auto paint = [&img, col](int n) { img.setPixel(n, col); };
+        auto isPainted = [&img, col](int n) { return img.getPixel(n) == col; };
+
+        if (connectivity == 8) floodZone<8>(i, j, paint, isPainted);
+
+        else floodZone<4>(i, j, paint, isPainted);
+
+        return img;
+    }
+
     // Pour chaque élément apartenant à la même zone que le pixel k de coordonnées (i,j),
     // le pixel correspondant est colorié de la couleur col.
-    for (list <int>::const_iterator it = part[k]->begin(); it != part[k]->end(); ++it) {
-
-        i = img.toCoordinate(*it).first;
-        j = img.toCoordinate(*it).second;
+    for (pmr::list <int>::const_iterator it = part[k]->begin(); it != part[k]->end(); ++it) {
 
-        img.setPixel(i, j, col);
+        img.setPixel(*it, col);
     }
 
     return img;
 }
 
+int Analyst::recolorZones(Image& img, const vector <pair <int, Color>>& recolors) {
+
+    AIP_TIMER("analyst.recolorZones");
+
+    assert(&img == pImg);
+
+    requirePartition();
+
+    if (zoneIds.empty()) {
+
+        numberZones();
+    }
+
+    // La nouvelle couleur de chaque zone, -1 pour une zone qui garde la sienne.
+    vector <int> target(zones, -1);
+
+    for (const pair <int, Color>& r : recolors) {
+
+        assert(0 <= r.first && r.first < zones);
+
+        target[r.first] = r.second.toInt();
+    }
+
+    int w = img.getWidth();
+    int h = img.getHeight();
+
+    // L'ancienne couleur des zones effectivement repeintes, -1 pour les autres.
+    vector <int> oldColors(zones, -1);
+
+    // Les paires de pixels voisins, l'un repeint, qui seront de même couleur dans des zones différentes.
+    vector <pair <int, int>> joins;
+
+    int repainted = 0;
+
+    for (int i = 0, k = 0; i < h; ++i) {
+
+        for (int j = 0; j < w; ++j, ++k) {
+
+            int z = zoneIds[Find(k)];
+            int col = target[z];
+
+            // Les zones sont d'une seule couleur : une zone déjà de sa nouvelle couleur n'a aucun pixel à repeindre.
+            if (col < 0 || img.getPixel(k).toInt() == col) continue;
+
+            oldColors[z] = img.getPixel(k).toInt();
+
+            img.setPixel(k, Color::makeColor(col));
+
+            --pixelsPerColor[oldColors[z]];
+            ++pixelsPerColor[col];
+            ++repainted;
+
+            // Avec le graphe, les contacts sont relevés à nouveau sur toute l'image (voir plus bas).
+            if (withGraph) continue;
+
+            // La couleur finale d'un voisin est sa nouvelle couleur s'il est repeint, qu'il l'ait déjà été ou non.
+            auto join = [this, &img, &target, &joins, k, col](int n) {
+
+                int r = Find(n);
+
+                if (r != Find(k) && (target[zoneIds[r]] >= 0 ? target[zoneIds[r]] : img.getPixel(n).toInt()) == col) {
+
+                    joins.push_back(make_pair(k, n));
+                }
+            };
+
+            if (connectivity == 8) NeighbourLoop <8>::apply(i, j, w, h, join);
+
+            else NeighbourLoop <4>::apply(i, j, w, h, join);
+        }
+    }
+
+    if (repainted == 0) return 0;
+
+    // Une zone repeinte change de couleur d'un bloc.
+    for (int z = 0; z < static_cast<int>(oldColors.size()); ++z) {
+
+        if (oldColors[z] >= 0) {
+
+            --zonesPerColor[oldColors[z]];
+            ++zonesPerColor[target[z]];
+        }
+    }
+
+    // Les zones repeintes rejoignent leurs voisines de même couleur. Avec le graphe, un nouveau
+    // parcours de fusion fait les mêmes réunions et relève les contacts entre couleurs.
+    if (withGraph) {
+
+        if (connectivity == 8) UnionZones<8>();
+
+        else UnionZones<4>();
+
+        buildRegionGraph();
+    }
+
+    else {
+
+        for (const pair <int, int>& p : joins) {
+
+            if (Find(p.first) != Find(p.second)) {
+
+                Union(p.first, p.second);
+
+                --zones;
+                --zonesPerColor[img.getPixel(p.first).toInt()];
+            }
+        }
+
+        // Des zones ont pu être réunies : elles sont renumérotées à la prochaine question.
+        zoneIds.clear();
+    }
+
+    AIP_COUNT("analyst.recolored", repainted);
+
+    return repainted;
+}
+
+void Analyst::zoneTable(vector <Color>& colors, vector <int>& sizes) const {
+
+    requirePartition();
+
+    if (zoneIds.empty()) {
+
+        numberZones();
+    }
+
+    colors.assign(zones, Color::Black);
+    sizes.assign(zones, 0);
+
+    // Seul le représentant de chaque zone la décrit.
+    for (int k = 0; k < nbElem; ++k) {
+
+        if (Find(k) == k) {
+
+            colors[zoneIds[k]] = pImg->getPixel(k);
+            sizes[zoneIds[k]] = part[k]->size();
+        }
+    }
+}
+
 set <int> Analyst::zoneOfPixel(int i, int j) {
 
     set <int> s;
 
+    // Sans partition, la zone est parcourue de proche en proche depuis le pixel (i, j).
+    if (!isPartitioned()) {
+
+        auto insert = [&s](int n) { s.insert(n); };
+        auto isInserted = [&s](int n) { return s.count(n) > 0; };
+
+        if (connectivity == 8) floodZone<8>(i, j, insert, isInserted);
+
+        else floodZone<4>(i, j, insert, isInserted);
+
+        return s;
+    }
+
     int k = pImg->toIndex(i,j);
 
     // Chaque élément de la liste contenant le pixel k, de coordonnées (i,j), est inséré dans l'ensemble s.
-    for (list <int>::const_iterator it = part[k]->begin(); it != part[k]->end(); ++it) {
+    for (pmr::list <int>::const_iterator it = part[k]->begin(); it != part[k]->end(); ++it) {
 
         s.insert(*it);
     }
 
     return s;
-}
\ No newline at end of file
+}
+
+void Analyst::numberZones() const {
+
+    zoneIds.assign(nbElem, -1);
+
+    int next = 0;
+
+    // Le premier pixel rencontré de chaque zone donne son numéro au représentant de la zone.
+    for (int k = 0; k < nbElem; ++k) {
+
+        int r = Find(k);
+
+        if (zoneIds[r] == -1) {
+
+            zoneIds[r] = next++;
+        }
+    }
+}
+
+int Analyst::zoneIndex(int i, int j) {
+
+    requirePartition();
+
+    if (zoneIds.empty()) {
+
+        numberZones();
+    }
+
+    return zoneIds[Find(i, j)];
+}
+
+AnalysisResult Analyst::getResult() {
+
+    requirePartition();
+
+    if (zoneIds.empty()) {
+
+        numberZones();
+    }
+
+    AnalysisResult r;
+
+    r.width = pImg->getWidth();
+    r.height = pImg->getHeight();
+    r.connectivity = connectivity;
+    r.labels.resize(nbElem);
+    r.zoneColors.resize(zones);
+
+    for (int k = 0; k < nbElem; ++k) {
+
+        int z = zoneIds[Find(k)];
+
+        r.labels[k] = z;
+
+        // La couleur d'une zone est relevée au début de chaque suite de pixels de cette zone.
+        if (k == 0 || r.labels[k] != r.labels[k-1]) {
+
+            r.zoneColors[z] = pImg->getPixel(k);
+        }
+    }
+
+    r.complete();
+
+    return r;
+}
+
+void Analyst::buildRegionGraph() const {
+
+    AIP_TIMER("analyst.buildRegionGraph");
+
+    numberZones();
+
+    vector <Color> colors(zones);
+
+    for (int k = 0; k < nbElem; ++k) {
+
+        int r = Find(k);
+
+        // Seul le représentant de chaque zone fixe sa couleur.
+        if (r == k) {
+
+            colors[zoneIds[r]] = pImg->getPixel(k);
+        }
+    }
+
+    // Les contacts entre pixels deviennent des contacts entre zones, sans reparcourir l'image.
+    for (pair <int, int>& c : contacts) {
+
+        c.first = zoneIds[Find(c.first)];
+        c.second = zoneIds[Find(c.second)];
+    }
+
+    graph = RegionGraph(colors, contacts);
+
+    contacts.clear();
+    contacts.shrink_to_fit();
+}
+
+int Analyst::getConnectivity() const {
+
+    return connectivity;
+}
+
+bool Analyst::hasRegionGraph() const {
+
+    return withGraph;
+}
+
+const RegionGraph& Analyst::getRegionGraph() const {
+
+    assert(withGraph);
+
+    requirePartition();
+
+    return graph;
+}
@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include "../head/Analyst.h"
+#include "../head/ThreadPool.h"
+#include "../head/BatchAnalysis.h"
+
+vector <string> listAIPFiles(const string& path) {
+
+    namespace fs = std::filesystem;
+
+    vector <string> names;
+
+    if (fs::is_directory(path)) {
+
+        for (const fs::directory_entry& entry : fs::directory_iterator(path)) {
+
+            if (entry.is_regular_file() && entry.path().extension() == ".aip") {
+
+                names.push_back((entry.path().parent_path() / entry.path().stem()).string());
+            }
+        }
+
+        sort(names.begin(), names.end());
+    }
+
+    else if (fs::is_regular_file(path)) {
+
+        fs::path p(path);
+
+        names.push_back(p.extension() == ".aip" ? (p.parent_path() / p.stem()).string() : path);
+    }
+
+    // Un nom sans extension est accepté, comme pour Image::readAIP.
+    else if (fs::is_regular_file(path + ".aip")) {
+
+        names.push_back(path);
+    }
+
+    else throw runtime_error("error no such file or directory (" + path + ")");
+
+    return names;
+}
+
+// Place occupée par la partition d'un Analyst, par pixel : un nœud de liste, une liste et un pointeur.
+static const size_t arenaBytesPerPixel = 80;
+
+// Analyse une image lue et remplit le rapport. Les listes de la partition sont allouées dans
+// une arène propre au fil, vidée après chaque image. Son tampon, dimensionné par la première
+// image et agrandi seulement pour une image plus grande, sert à toutes les images du fil : en
+// régime établi, l'analyse ne demande plus rien au tas.
+static void analyseImage(const Image& img, int connectivity, FileReport& report) {
+
+    static thread_local unique_ptr <char[]> buffer;
+    static thread_local size_t bufferSize = 0;
+    static thread_local unique_ptr <pmr::monotonic_buffer_resource> arena;
+
+    size_t needed = arenaBytesPerPixel * img.getSize();
+
+    if (bufferSize < needed) {
+
+        arena.reset();
+        buffer.reset(new char[needed]);
+        bufferSize = needed;
+        arena.reset(new pmr::monotonic_buffer_resource(buffer.get(), bufferSize));
+    }
+
+    {
+        Analyst a(img, false, connectivity, arena.get());
+
+        report.width = img.getWidth();
+        report.height = img.getHeight();
+        report.nbZones = a.nbZones();
+
+        for (int c = 0; c < Color::nbColors(); ++c) {
+
+            report.pixelsPerColor.push_back(a.nbPixelsOfColor(Color::makeColor(c)));
+            report.zonesPerColor.push_back(a.nbZonesOfColor(Color::makeColor(c)));
+        }
+    }
+
+    // L'arène repart du début de son tampon; ce qu'elle a dû demander au tas en plus est rendu.
+    arena->release();
+}
+
+vector <FileReport> analyseFiles(const vector <string>& names, const BatchParameters& p) {
+
+    assert(p.connectivity == 4 || p.connectivity == 8);
+
+    vector <FileReport> reports(names.size());
+
+    ThreadPool pool(p.nbThreads);
+
+    for (size_t f = 0; f < names.size(); ++f) {
+
+        reports[f].name = names[f];
+        reports[f].width = reports[f].height = reports[f].nbZones = 0;
+
+        // Chaque rapport n'est rempli que par les tâches de son fichier : aucun verrou n'est nécessaire.
+        pool.submit([&pool, &reports, f, p]() {
+
+            FileReport& report = reports[f];
+            shared_ptr <const Image> img;
+
+            try {
+
+                img = make_shared <const Image>(Image::readAIP(report.name));
+            }
+            catch (const exception& e) {
+
+                report.error = e.what();
+                return;
+            }
+
+            // L'analyse est soumise depuis ce fil : elle passe avant les lectures en attente,
+            // ce qui limite le nombre d'images en mémoire au nombre de fils.
+            pool.submit([img, &report, p]() { analyseImage(*img, p.connectivity, report); });
+        });
+    }
+
+    pool.wait();
+
+    return reports;
+}
+
+// Retourne le nom de la couleur numéro c (black, white...).
+static string colorName(int c) {
+
+    ostringstream name;
+
+    name << Color::makeColor(c);
+
+    return name.str();
+}
+
+// Retourne text entre guillemets, avec les caractères spéciaux du JSON échappés.
+static string jsonString(const string& text) {
+
+    string quoted = "\"";
+
+    for (char c : text) {
+
+        if (c == '"' || c == '\\') quoted += '\\';
+
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+// Retourne text entre guillemets, les guillemets qu'il contient étant doublés (champ CSV).
+static string csvString(const string& text) {
+
+    string quoted = "\"";
+
+    for (char c : text) {
+
+        if (c == '"') quoted += '"';
+
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+void writeReportsCSV(ostream& out, const vector <FileReport>& reports) {
+
+    out << "file,width,height,zones";
+
+    for (int c = 0; c < Color::nbColors(); ++c) {
+
+        out << "," << colorName(c) << "_pixels," << colorName(c) << "_zones";
+    }
+
+    out << ",error\n";
+
+    for (const FileReport& r : reports) {
+
+        out << csvString(r.name) << "," << r.width << "," << r.height << "," << r.nbZones;
+
+        for (int c = 0; c < Color::nbColors(); ++c) {
+
+            if (r.error.empty()) out << "," << r.pixelsPerColor[c] << "," << r.zonesPerColor[c];
+
+            else out << ",,";
+        }
+
+        out << "," << (r.error.empty() ? "" : csvString(r.error)) << "\n";
+    }
+}
+
+void writeReportsJSON(ostream& out, const vector <FileReport>& reports) {
+
+    out << "{\n  \"files\": [\n";
+
+    for (size_t f = 0; f < reports.size(); ++f) {
+
+        const FileReport& r = reports[f];
+
+        out << "    {\"file\": " << jsonString(r.name);
+
+        if (!r.error.empty()) out << ", \"error\": " << jsonString(r.error);
+
+        else {
+
+            out << ", \"width\": " << r.width << ", \"height\": " << r.height << ", \"zones\": " << r.nbZones;
+
+            for (int c = 0; c < Color::nbColors(); ++c) {
+
+                out << ", \"" << colorName(c) << "_pixels\": " << r.pixelsPerColor[c]
+                    << ", \"" << colorName(c) << "_zones\": " << r.zonesPerColor[c];
+            }
+        }
+
+        out << "}" << (f + 1 < reports.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n}\n";
+}
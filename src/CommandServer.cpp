@@ -0,0 +1,646 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../head/Metrics.h"
+#include "../head/RasterWriter.h"
+#include "../head/TerrainGenerator.h"
+#include "../head/CommandServer.h"
+
+// Taille maximale d'une commande : une connexion qui envoie davantage sans fin de ligne est fermée.
+static const size_t maxLineLength = 1 << 24;
+
+// Dimension maximale d'un terrain généré par load.
+static const int maxTerrainSide = 16384;
+
+// Nombre maximal d'étapes d'une commande step.
+static const int maxSteps = 100000;
+
+// Retourne le nom de la couleur c (black, white...).
+static string colorName(Color c) {
+
+    ostringstream name;
+
+    name << c;
+
+    return name.str();
+}
+
+// Retourne la couleur désignée par value, son nom ou son numéro.
+static Color parseColor(const JsonValue& value) {
+
+    if (value.getType() == JsonValue::Number) {
+
+        double n = value.asNumber();
+
+        // L'intervalle est vérifié avant la conversion, sans effet défini hors des int.
+        if (n >= 0 && n < Color::nbColors() && n == floor(n)) return Color::makeColor(static_cast<int>(n));
+    }
+
+    else if (value.getType() == JsonValue::String) {
+
+        for (int c = 0; c < Color::nbColors(); ++c) {
+
+            if (colorName(Color::makeColor(c)) == value.asString()) return Color::makeColor(c);
+        }
+    }
+
+    throw runtime_error("unknown color");
+}
+
+// Retourne le numéro du pixel désigné par les champs "i" et "j" de request.
+static int pixelOf(const JsonValue& request, const Image& img) {
+
+    int i = request.getInt("i", -1);
+    int j = request.getInt("j", -1);
+
+    if (i < 0 || i >= img.getHeight() || j < 0 || j >= img.getWidth()) throw runtime_error("pixel out of image");
+
+    return img.toIndex(i, j);
+}
+
+CommandServer::CommandServer(size_t cacheCapacity)
+    : cache4(cacheCapacity, "", 4), cache8(cacheCapacity, "", 8), stopping(false), listenFd(-1) {}
+
+string CommandServer::execute(const string& line) {
+
+    AIP_TIMER("server.command");
+    AIP_COUNT("server.commands", 1);
+
+    JsonValue reply = JsonValue::object();
+    JsonValue id;
+
+    try {
+
+        JsonValue request = JsonValue::parse(line);
+
+        if (request.getType() != JsonValue::Object) throw runtime_error("a command must be a JSON object");
+
+        id = request.get("id");
+
+        if (id.getType() != JsonValue::Null) reply.set("id", id);
+
+        reply.set("ok", true);
+
+        dispatch(request, reply);
+    }
+    catch (const exception& e) {
+
+        // Les résultats partiels sont abandonnés : seuls l'identifiant et l'erreur sont rendus.
+        reply = JsonValue::object();
+
+        if (id.getType() != JsonValue::Null) reply.set("id", id);
+
+        reply.set("ok", false);
+        reply.set("error", e.what());
+    }
+
+    return reply.toString();
+}
+
+void CommandServer::dispatch(const JsonValue& request, JsonValue& reply) {
+
+    string cmd = request.getString("cmd", "");
+
+    if (cmd == "load") load(request, reply);
+    else if (cmd == "unload") unload(request, reply);
+    else if (cmd == "sessions") listSessions(reply);
+    else if (cmd == "stats") stats(request, reply);
+    else if (cmd == "zone") zone(request, reply);
+    else if (cmd == "fill") fill(request, reply);
+    else if (cmd == "ignite") ignite(request, reply);
+    else if (cmd == "step") step(request, reply);
+    else if (cmd == "frame") frame(request, reply);
+    else if (cmd == "delta") delta(request, reply);
+    else if (cmd == "save") save(request, reply);
+    else if (cmd == "shutdown") stop();
+    else throw runtime_error("unknown command " + cmd);
+}
+
+shared_ptr <CommandServer::Session> CommandServer::findSession(const JsonValue& request) const {
+
+    string name = request.getString("session", "");
+
+    lock_guard <mutex> guard(sessionsLock);
+
+    map <string, shared_ptr <Session>>::const_iterator it = sessions.find(name);
+
+    if (it == sessions.end()) throw runtime_error("unknown session " + name);
+
+    return it->second;
+}
+
+shared_ptr <const AnalysisResult> CommandServer::analysisOf(Session& s, const JsonValue& request) {
+
+    int connectivity = request.getInt("connectivity", 4);
+
+    if (connectivity != 4 && connectivity != 8) throw runtime_error("connectivity must be 4 or 8");
+
+    shared_ptr <const AnalysisResult>& r = s.analyses[connectivity == 8];
+
+    // Une même image chargée dans plusieurs sessions n'est analysée qu'une fois.
+    if (!r) r = (connectivity == 8 ? cache8 : cache4).analyse(*s.image);
+
+    return r;
+}
+
+void CommandServer::load(const JsonValue& request, JsonValue& reply) {
+
+    string name = request.getString("session", "");
+
+    if (name.empty()) throw runtime_error("missing session");
+
+    shared_ptr <Session> s = make_shared <Session>();
+
+    // L'image est lue ou générée avant de toucher aux sessions : les autres commandes continuent.
+    if (request.has("file")) {
+
+        // Un fichier ne peut annoncer une image plus grande qu'un terrain généré.
+        s->image = make_shared <const Image>(Image::readAIP(request.getString("file", ""),
+                                                            static_cast<long long>(maxTerrainSide) * maxTerrainSide));
+    }
+
+    else {
+
+        int w = request.getInt("width", 0);
+        int h = request.getInt("height", 0);
+
+        if (w < 1 || h < 1 || w > maxTerrainSide || h > maxTerrainSide) throw runtime_error("bad terrain size");
+
+        TerrainParameters p;
+        p.seed = request.getInt("seed", 1);
+        p.nbThreads = 1; // Les sessions se partagent déjà les cœurs.
+
+        s->image = make_shared <const Image>(makeTerrainImage(w, h, p));
+    }
+
+    {
+        lock_guard <mutex> guard(sessionsLock);
+
+        // Une commande en cours sur l'ancienne session la garde en vie jusqu'à sa fin.
+        sessions[name] = s;
+    }
+
+    reply.set("width", s->image->getWidth());
+    reply.set("height", s->image->getHeight());
+}
+
+void CommandServer::unload(const JsonValue& request, JsonValue& reply) {
+
+    string name = request.getString("session", "");
+
+    lock_guard <mutex> guard(sessionsLock);
+
+    if (sessions.erase(name) == 0) throw runtime_error("unknown session " + name);
+
+    reply.set("sessions", static_cast<int>(sessions.size()));
+}
+
+void CommandServer::listSessions(JsonValue& reply) const {
+
+    JsonValue names = JsonValue::array();
+
+    lock_guard <mutex> guard(sessionsLock);
+
+    for (const pair <const string, shared_ptr <Session>>& s : sessions) {
+
+        names.push(s.first);
+    }
+
+    reply.set("sessions", names);
+}
+
+void CommandServer::stats(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    shared_ptr <const AnalysisResult> r = analysisOf(*s, request);
+
+    vector <int> pixels(Color::nbColors(), 0);
+    vector <int> zones(Color::nbColors(), 0);
+
+    for (int z = 0; z < r->nbZones(); ++z) {
+
+        pixels[r->zoneColors[z].toInt()] += r->zoneSize(z);
+        ++zones[r->zoneColors[z].toInt()];
+    }
+
+    JsonValue pixelsPerColor = JsonValue::object();
+    JsonValue zonesPerColor = JsonValue::object();
+
+    for (int c = 0; c < Color::nbColors(); ++c) {
+
+        pixelsPerColor.set(colorName(Color::makeColor(c)), pixels[c]);
+        zonesPerColor.set(colorName(Color::makeColor(c)), zones[c]);
+    }
+
+    reply.set("width", s->image->getWidth());
+    reply.set("height", s->image->getHeight());
+    reply.set("zones", r->nbZones());
+    reply.set("pixelsPerColor", pixelsPerColor);
+    reply.set("zonesPerColor", zonesPerColor);
+}
+
+void CommandServer::zone(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    int k = pixelOf(request, *s->image);
+
+    shared_ptr <const AnalysisResult> r = analysisOf(*s, request);
+
+    int z = r->labels[k];
+
+    reply.set("zone", z);
+    reply.set("color", colorName(r->zoneColors[z]));
+    reply.set("size", r->zoneSize(z));
+}
+
+void CommandServer::fill(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    int k = pixelOf(request, *s->image);
+    Color c = parseColor(request.get("color"));
+
+    shared_ptr <const AnalysisResult> r = analysisOf(*s, request);
+
+    int z = r->labels[k];
+
+    if (r->zoneColors[z] == c) {
+
+        reply.set("repainted", 0);
+        return;
+    }
+
+    // Les pixels de la zone sont rangés ensemble dans le résultat : aucun parcours n'est nécessaire.
+    shared_ptr <Image> next = make_shared <Image>(*s->image);
+
+    for (int n = r->zoneOffsets[z]; n < r->zoneOffsets[z + 1]; ++n) {
+
+        next->setPixel(r->zonePixels[n], c);
+    }
+
+    s->image = next;
+    s->analyses[0].reset();
+    s->analyses[1].reset();
+
+    reply.set("repainted", r->zoneSize(z));
+}
+
+void CommandServer::ignite(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    int k = pixelOf(request, *s->image);
+
+    if (!DefaultFireRules::isFuel(s->image->getPixel(k))) throw runtime_error("fire must start on fuel");
+
+    // L'ancienne simulation est détruite avant son image.
+    s->simulator.reset();
+    s->simImage.reset(new Image(*s->image));
+    s->simulator.reset(new FireSimulator(*s->simImage, k));
+
+    if (request.has("seed")) s->simulator->setSeed(request.getInt("seed", 0));
+
+    s->lastSent.reset(new Image(*s->image));
+
+    reply.set("time", s->simulator->getTime());
+}
+
+void CommandServer::step(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    if (!s->simulator) throw runtime_error("no simulation in session");
+
+    int n = request.getInt("n", 1);
+
+    if (n < 1 || n > maxSteps) throw runtime_error("bad number of steps");
+
+    // Une fois l'incendie éteint, les étapes suivantes ne changeraient plus rien.
+    for (int t = 0; t < n && !s->simulator->isExtinct(); ++t) {
+
+        s->simulator->nextStage();
+    }
+
+    reply.set("time", s->simulator->getTime());
+    reply.set("burning", s->simulator->nbBurning());
+    reply.set("extinct", s->simulator->isExtinct());
+}
+
+void CommandServer::frame(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    const Image& img = s->simImage ? *s->simImage : *s->image;
+
+    JsonValue rows = JsonValue::array();
+    string row(img.getWidth(), '0');
+
+    for (int i = 0, k = 0; i < img.getHeight(); ++i) {
+
+        for (int j = 0; j < img.getWidth(); ++j, ++k) {
+
+            row[j] = static_cast<char>('0' + img.getPixel(k).toInt());
+        }
+
+        rows.push(row);
+    }
+
+    s->lastSent.reset(new Image(img));
+
+    reply.set("width", img.getWidth());
+    reply.set("height", img.getHeight());
+
+    if (s->simulator) reply.set("time", s->simulator->getTime());
+
+    reply.set("rows", rows);
+}
+
+void CommandServer::delta(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    const Image& img = s->simImage ? *s->simImage : *s->image;
+
+    // Sans frame préalable, les changements sont comptés depuis l'image chargée.
+    const Image& base = s->lastSent ? *s->lastSent : *s->image;
+
+    JsonValue pixels = JsonValue::array();
+
+    for (int k : base.changedPixels(img)) {
+
+        JsonValue p = JsonValue::array();
+
+        p.push(k);
+        p.push(img.getPixel(k).toInt());
+
+        pixels.push(p);
+    }
+
+    s->lastSent.reset(new Image(img));
+
+    if (s->simulator) reply.set("time", s->simulator->getTime());
+
+    reply.set("pixels", pixels);
+}
+
+void CommandServer::save(const JsonValue& request, JsonValue& reply) {
+
+    shared_ptr <Session> s = findSession(request);
+
+    lock_guard <mutex> guard(s->lock);
+
+    const Image& img = s->simImage ? *s->simImage : *s->image;
+
+    string file = request.getString("file", "");
+    string format = request.getString("format", "aip");
+
+    if (file.empty()) throw runtime_error("missing file");
+
+    int pixelSize = request.getInt("pixelSize", 1);
+
+    if (pixelSize < 1) throw runtime_error("bad pixel size");
+
+    // Les dimensions de l'image agrandie doivent rester des int.
+    if (img.getWidth() > INT_MAX / pixelSize || img.getHeight() > INT_MAX / pixelSize) {
+
+        throw runtime_error("pixel size too large for this image");
+    }
+
+    if (format == "aip") img.writeAIP(file);
+
+    else if (format == "svg") img.writeSVG(file, pixelSize);
+
+    else if (format == "ppm") RasterWriter(pixelSize).writePPM(img, file);
+
+    else if (format == "png") RasterWriter(pixelSize).writePNG(img, file);
+
+    else throw runtime_error("format must be aip, svg, ppm or png");
+
+    reply.set("file", file + "." + format);
+}
+
+void CommandServer::stop() {
+
+    stopping = true;
+
+    // Débloque l'attente de connexions et la lecture des connexions ouvertes; les réponses
+    // en cours d'écriture partent encore.
+    lock_guard <mutex> guard(clientsLock);
+
+    if (listenFd >= 0) ::shutdown(listenFd, SHUT_RDWR);
+
+    for (int fd : clients) {
+
+        ::shutdown(fd, SHUT_RD);
+    }
+}
+
+int CommandServer::nbSessions() const {
+
+    lock_guard <mutex> guard(sessionsLock);
+
+    return sessions.size();
+}
+
+bool CommandServer::isShutdown() const {
+
+    return stopping;
+}
+
+void CommandServer::serve(istream& in, ostream& out) {
+
+    string line;
+
+    while (!stopping && getline(in, line)) {
+
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        if (line.empty()) continue;
+
+        out << execute(line) << "\n" << flush;
+    }
+}
+
+// Écrit les size octets de data sur fd. Retourne faux si la connexion est fermée.
+static bool sendAll(int fd, const char* data, size_t size) {
+
+    while (size > 0) {
+
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+
+        if (n < 0 && errno == EINTR) continue;
+
+        if (n <= 0) return false;
+
+        data += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+void CommandServer::serveClient(int fd) {
+
+    string buffer;
+    char chunk[65536];
+    bool open = true;
+
+    while (open) {
+
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+
+        if (n < 0 && errno == EINTR) continue;
+
+        if (n <= 0) break;
+
+        buffer.append(chunk, n);
+
+        // Chaque ligne complète est exécutée; la fin incomplète attend la suite.
+        size_t start = 0;
+
+        for (size_t end; open && (end = buffer.find('\n', start)) != string::npos; start = end + 1) {
+
+            string line = buffer.substr(start, end - start);
+
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+
+            if (line.empty()) continue;
+
+            string reply = execute(line) + "\n";
+
+            open = sendAll(fd, reply.data(), reply.size());
+        }
+
+        buffer.erase(0, start);
+
+        if (buffer.size() > maxLineLength) break;
+    }
+
+    lock_guard <mutex> guard(clientsLock);
+
+    clients.erase(fd);
+    close(fd);
+
+    // Le fil de la connexion sera joint par serveSocket à la prochaine connexion acceptée.
+    finishedClients.push_back(this_thread::get_id());
+}
+
+void CommandServer::serveSocket(const string& path) {
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) throw runtime_error("error open socket (" + path + ")");
+
+    strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) throw runtime_error("error open socket (" + path + ")");
+
+    unlink(path.c_str());
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 16) < 0) {
+
+        close(fd);
+        throw runtime_error("error open socket (" + path + ")");
+    }
+
+    {
+        lock_guard <mutex> guard(clientsLock);
+
+        listenFd = fd;
+    }
+
+    // Les fils des connexions en cours, ou terminées mais pas encore jointes.
+    map <thread::id, thread> threads;
+
+    // stop débloque accept en fermant la socket d'écoute.
+    while (!stopping) {
+
+        int client = accept(fd, nullptr, nullptr);
+
+        if (client < 0) {
+
+            if (errno == EINTR) continue;
+
+            break;
+        }
+
+        vector <thread::id> finished;
+
+        {
+            lock_guard <mutex> guard(clientsLock);
+
+            if (stopping) {
+
+                close(client);
+                break;
+            }
+
+            clients.insert(client);
+
+            thread th(&CommandServer::serveClient, this, client);
+            threads[th.get_id()] = move(th);
+
+            finished.swap(finishedClients);
+        }
+
+        // Les fils des connexions fermées depuis la précédente sont joints : un serveur qui
+        // reçoit de nombreuses connexions courtes ne garde que les fils de celles qui restent ouvertes.
+        for (const thread::id& id : finished) {
+
+            threads[id].join();
+            threads.erase(id);
+        }
+    }
+
+    {
+        lock_guard <mutex> guard(clientsLock);
+
+        listenFd = -1;
+    }
+
+    close(fd);
+    unlink(path.c_str());
+
+    for (pair <const thread::id, thread>& t : threads) {
+
+        t.second.join();
+    }
+
+    finishedClients.clear();
+}
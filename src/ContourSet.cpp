@@ -0,0 +1,477 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "../head/Analyst.h"
+#include "../head/ContourSet.h"
+
+// Les directions d'un bord, dans le sens des aiguilles d'une montre à l'écran (y vers le bas).
+// Tourner à droite revient à ajouter 1, à gauche à ajouter 3.
+enum Direction { East = 0, South = 1, West = 2, North = 3 };
+
+static const int dx[4] = { 1, 0, -1, 0 };
+static const int dy[4] = { 0, 1, 0, -1 };
+
+// Un bord de pixel orienté, la zone étant à sa droite.
+struct Edge {
+
+    int x, y; // Sommet de départ.
+    int dir;
+};
+
+// Aire signée d'un contour : positive pour un bord extérieur, négative pour un trou.
+static long long signedArea(const ContourRing& ring) {
+
+    long long area = 0;
+
+    for (size_t p = 0; p < ring.size(); ++p) {
+
+        const pair <int, int>& a = ring[p];
+        const pair <int, int>& b = ring[(p + 1) % ring.size()];
+
+        area += static_cast<long long>(a.first) * b.second - static_cast<long long>(b.first) * a.second;
+    }
+
+    return area;
+}
+
+ContourSet::ContourSet(int w, int h) : width(w), height(h) {}
+
+ContourSet::ContourSet(const AnalysisResult& result, Color c) : ContourSet(result.width, result.height) {
+
+    for (int z = 0; z < result.nbZones(); ++z) {
+
+        if (result.zoneColors[z] == c) traceZone(result, z);
+    }
+}
+
+ContourSet::ContourSet(const Image& img, Color c, int connectivity)
+    : ContourSet(Analyst(img, false, connectivity).getResult(), c) {}
+
+ContourSet ContourSet::ofZone(const AnalysisResult& result, int zone) {
+
+    assert(zone >= 0 && zone < result.nbZones());
+
+    ContourSet set(result.width, result.height);
+
+    set.traceZone(result, zone);
+
+    return set;
+}
+
+void ContourSet::traceZone(const AnalysisResult& result, int z) {
+
+    int w = result.width;
+    int h = result.height;
+
+    const int* labels = result.labels.data();
+
+    // Un bord est relevé sur chaque côté d'un pixel de la zone qui touche une autre zone ou le bord de l'image.
+    vector <Edge> edges;
+
+    for (int p = result.zoneOffsets[z]; p < result.zoneOffsets[z + 1]; ++p) {
+
+        int k = result.zonePixels[p];
+        int i = k / w;
+        int j = k % w;
+
+        if (i == 0 || labels[k - w] != z) edges.push_back({ j, i, East });
+        if (j == w - 1 || labels[k + 1] != z) edges.push_back({ j + 1, i, South });
+        if (i == h - 1 || labels[k + w] != z) edges.push_back({ j + 1, i + 1, West });
+        if (j == 0 || labels[k - 1] != z) edges.push_back({ j, i + 1, North });
+    }
+
+    // Les bords qui partent de chaque sommet : deux au plus, là où deux pixels de la zone
+    // ne se touchent que par un coin.
+    unordered_map <long long, array <int, 2>> outgoing;
+
+    outgoing.reserve(edges.size());
+
+    for (size_t e = 0; e < edges.size(); ++e) {
+
+        long long v = static_cast<long long>(edges[e].y) * (w + 1) + edges[e].x;
+
+        auto found = outgoing.emplace(v, array <int, 2> {{ static_cast<int>(e), -1 }});
+
+        if (!found.second) found.first->second[1] = e;
+    }
+
+    // À un tel sommet, la 4-connexité sépare les deux pixels (le contour tourne à droite),
+    // la 8-connexité les relie (le contour tourne à gauche). Chaque zone a ainsi un seul bord extérieur.
+    int turn = (result.connectivity == 8) ? 3 : 1;
+
+    vector <bool> used(edges.size(), false);
+
+    ZonePolygon polygon;
+
+    polygon.zone = z;
+    polygon.color = result.zoneColors[z];
+    polygon.rings.push_back(ContourRing());
+
+    for (size_t start = 0; start < edges.size(); ++start) {
+
+        if (used[start]) continue;
+
+        ContourRing ring;
+
+        int e = start;
+
+        do {
+
+            used[e] = true;
+
+            int x = edges[e].x + dx[edges[e].dir];
+            int y = edges[e].y + dy[edges[e].dir];
+
+            const array <int, 2>& out = outgoing.at(static_cast<long long>(y) * (w + 1) + x);
+
+            int next = out[0];
+
+            if (out[1] != -1 && edges[out[0]].dir != (edges[e].dir + turn) % 4) next = out[1];
+
+            // Seuls les changements de direction sont des sommets du contour.
+            if (edges[next].dir != edges[e].dir) ring.push_back(make_pair(x, y));
+
+            e = next;
+
+        } while (e != static_cast<int>(start));
+
+        if (signedArea(ring) > 0) {
+
+            assert(polygon.rings[0].empty());
+
+            polygon.rings[0] = move(ring);
+        }
+
+        else polygon.rings.push_back(move(ring));
+    }
+
+    polygons.push_back(move(polygon));
+}
+
+int ContourSet::getWidth() const {
+
+    return width;
+}
+
+int ContourSet::getHeight() const {
+
+    return height;
+}
+
+const vector <ZonePolygon>& ContourSet::getPolygons() const {
+
+    return polygons;
+}
+
+int ContourSet::nbPoints() const {
+
+    int n = 0;
+
+    for (const ZonePolygon& polygon : polygons) {
+
+        for (const ContourRing& ring : polygon.rings) {
+
+            n += ring.size();
+        }
+    }
+
+    return n;
+}
+
+// Distance du point p au segment [a, b].
+static double segmentDistance(const pair <int, int>& p, const pair <int, int>& a, const pair <int, int>& b) {
+
+    double vx = b.first - a.first, vy = b.second - a.second;
+    double wx = p.first - a.first, wy = p.second - a.second;
+
+    double len = vx * vx + vy * vy;
+    double t = (len > 0) ? (wx * vx + wy * vy) / len : 0;
+
+    t = (t < 0) ? 0 : (t > 1 ? 1 : t);
+
+    return hypot(wx - t * vx, wy - t * vy);
+}
+
+// Simplifie un contour fermé : il est coupé en deux chaînes entre son premier sommet et le
+// sommet le plus éloigné de celui-ci, chacune simplifiée par Douglas-Peucker.
+static void simplifyRing(ContourRing& ring, double tolerance) {
+
+    int n = ring.size();
+
+    if (n <= 3) return;
+
+    int far = 0;
+    double farDist = -1;
+
+    for (int p = 1; p < n; ++p) {
+
+        double d = hypot(ring[p].first - ring[0].first, ring[p].second - ring[0].second);
+
+        if (d > farDist) {
+
+            far = p;
+            farDist = d;
+        }
+    }
+
+    vector <bool> keep(n, false);
+
+    keep[0] = keep[far] = true;
+
+    // Les chaînes à traiter, de first à last inclus; le sommet n est le sommet 0.
+    vector <pair <int, int>> chains = { { 0, far }, { far, n } };
+
+    while (!chains.empty()) {
+
+        int first = chains.back().first;
+        int last = chains.back().second;
+
+        chains.pop_back();
+
+        int worst = -1;
+        double worstDist = tolerance;
+
+        for (int p = first + 1; p < last; ++p) {
+
+            double d = segmentDistance(ring[p], ring[first], ring[last % n]);
+
+            if (d > worstDist) {
+
+                worst = p;
+                worstDist = d;
+            }
+        }
+
+        if (worst != -1) {
+
+            keep[worst] = true;
+            chains.push_back(make_pair(first, worst));
+            chains.push_back(make_pair(worst, last));
+        }
+    }
+
+    ContourRing simplified;
+
+    for (int p = 0; p < n; ++p) {
+
+        if (keep[p]) simplified.push_back(ring[p]);
+    }
+
+    if (simplified.size() >= 3) ring = move(simplified);
+}
+
+void ContourSet::simplify(double tolerance) {
+
+    assert(tolerance >= 0);
+
+    for (ZonePolygon& polygon : polygons) {
+
+        for (ContourRing& ring : polygon.rings) {
+
+            simplifyRing(ring, tolerance);
+        }
+    }
+}
+
+void ContourSet::writeSVG(const string& filename, int pixelSize) const {
+
+    assert(pixelSize > 0);
+
+    ofstream file;
+    file.open(filename + ".svg");
+
+    if (!file) throw runtime_error("error open file (write contours SVG)");
+
+    file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" << endl
+         << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << pixelSize * width
+         << "\" height=\"" << pixelSize * height << "\">" << endl;
+
+    // Un chemin par zone : le remplissage pair-impair laisse ses trous vides.
+    for (const ZonePolygon& polygon : polygons) {
+
+        file << "<path fill=\"" << polygon.color << "\" fill-rule=\"evenodd\" d=\"";
+
+        for (const ContourRing& ring : polygon.rings) {
+
+            for (size_t p = 0; p < ring.size(); ++p) {
+
+                file << (p == 0 ? "M" : " ") << pixelSize * ring[p].first << " " << pixelSize * ring[p].second;
+            }
+
+            file << "Z";
+        }
+
+        file << "\" />" << endl;
+    }
+
+    file << "</svg>" << endl;
+}
+
+// Ajoute n à out en entier de longueur variable : 7 bits par octet, le bit de poids fort
+// indiquant qu'un octet suit.
+static void putVarint(vector <uint8_t>& out, uint32_t n) {
+
+    while (n >= 0x80) {
+
+        out.push_back(static_cast<uint8_t>(n | 0x80));
+        n >>= 7;
+    }
+
+    out.push_back(static_cast<uint8_t>(n));
+}
+
+// Les différences signées sont entrelacées (0, -1, 1, -2...) pour rester courtes.
+static void putSigned(vector <uint8_t>& out, int n) {
+
+    putVarint(out, (static_cast<uint32_t>(n) << 1) ^ static_cast<uint32_t>(n >> 31));
+}
+
+// Lit un entier de longueur variable à la position pos de data.
+static uint32_t getVarint(const vector <uint8_t>& data, size_t& pos) {
+
+    uint32_t n = 0;
+
+    for (int shift = 0; shift < 35; shift += 7) {
+
+        if (pos >= data.size()) throw runtime_error("error bad format (read contours)");
+
+        uint8_t byte = data[pos++];
+
+        n |= static_cast<uint32_t>(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) return n;
+    }
+
+    throw runtime_error("error bad format (read contours)");
+}
+
+static int getSigned(const vector <uint8_t>& data, size_t& pos) {
+
+    uint32_t n = getVarint(data, pos);
+
+    return static_cast<int>(n >> 1) ^ -static_cast<int>(n & 1);
+}
+
+// Format du fichier '.aic' : "AIPC", puis en entiers de longueur variable la version, les
+// dimensions et le nombre de zones; pour chaque zone, son numéro, sa couleur et son nombre
+// de contours; pour chaque contour, son nombre de sommets puis chaque sommet en différence
+// avec le précédent (le premier avec (0, 0)).
+static const uint32_t contourVersion = 1;
+
+void ContourSet::writeBinary(const string& filename) const {
+
+    vector <uint8_t> data = { 'A', 'I', 'P', 'C' };
+
+    putVarint(data, contourVersion);
+    putVarint(data, width);
+    putVarint(data, height);
+    putVarint(data, polygons.size());
+
+    for (const ZonePolygon& polygon : polygons) {
+
+        putVarint(data, polygon.zone);
+        putVarint(data, polygon.color.toInt());
+        putVarint(data, polygon.rings.size());
+
+        for (const ContourRing& ring : polygon.rings) {
+
+            putVarint(data, ring.size());
+
+            pair <int, int> last(0, 0);
+
+            for (const pair <int, int>& p : ring) {
+
+                putSigned(data, p.first - last.first);
+                putSigned(data, p.second - last.second);
+
+                last = p;
+            }
+        }
+    }
+
+    ofstream file(filename + ".aic", ios::binary);
+
+    if (!file) throw runtime_error("error open file (write contours)");
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    if (!file) throw runtime_error("error open file (write contours)");
+}
+
+ContourSet ContourSet::readBinary(const string& filename) {
+
+    ifstream file(filename + ".aic", ios::binary);
+
+    if (!file) throw runtime_error("error open file (read contours)");
+
+    vector <uint8_t> data((istreambuf_iterator <char>(file)), istreambuf_iterator <char>());
+
+    if (data.size() < 4 || data[0] != 'A' || data[1] != 'I' || data[2] != 'P' || data[3] != 'C') {
+
+        throw runtime_error("error bad format (read contours)");
+    }
+
+    size_t pos = 4;
+
+    if (getVarint(data, pos) != contourVersion) throw runtime_error("error bad version (read contours)");
+
+    int w = getVarint(data, pos);
+    int h = getVarint(data, pos);
+
+    ContourSet set(w, h);
+
+    // Chaque élément occupe au moins un octet : les tailles lues sont bornées par celle du fichier.
+    uint32_t nbPolygons = getVarint(data, pos);
+
+    if (nbPolygons > data.size()) throw runtime_error("error bad format (read contours)");
+
+    set.polygons.resize(nbPolygons);
+
+    for (ZonePolygon& polygon : set.polygons) {
+
+        polygon.zone = getVarint(data, pos);
+
+        uint32_t color = getVarint(data, pos);
+
+        if (color >= static_cast<uint32_t>(Color::nbColors())) throw runtime_error("error bad format (read contours)");
+
+        polygon.color = Color::makeColor(color);
+
+        uint32_t nbRings = getVarint(data, pos);
+
+        if (nbRings > data.size()) throw runtime_error("error bad format (read contours)");
+
+        polygon.rings.resize(nbRings);
+
+        for (ContourRing& ring : polygon.rings) {
+
+            uint32_t nbVertices = getVarint(data, pos);
+
+            if (nbVertices > data.size()) throw runtime_error("error bad format (read contours)");
+
+            pair <int, int> last(0, 0);
+
+            for (uint32_t p = 0; p < nbVertices; ++p) {
+
+                last.first += getSigned(data, pos);
+                last.second += getSigned(data, pos);
+
+                ring.push_back(last);
+            }
+        }
+    }
+
+    return set;
+}
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "../head/Parallel.h"
+#include "../head/DistanceMap.h"
+
+// Conversion d'une distance réelle vers le type stocké par la carte.
+static inline void store(float& out, double d) {
+
+    out = static_cast<float>(d);
+}
+
+// Les distances entières sont arrondies et saturées à la plus grande valeur représentable.
+static inline void store(uint16_t& out, double d) {
+
+    out = (d >= 65535.0) ? 65535 : static_cast<uint16_t>(d + 0.5);
+}
+
+template <>
+float DistanceMap <float>::infinity() {
+
+    return numeric_limits<float>::infinity();
+}
+
+template <>
+uint16_t DistanceMap <uint16_t>::infinity() {
+
+    return numeric_limits<uint16_t>::max();
+}
+
+template <typename T>
+DistanceMap <T>::DistanceMap(const Image& img, const vector <Color>& sources, Metric metric, int nbThreads) {
+
+    width = img.getWidth();
+    height = img.getHeight();
+
+    this->metric = metric;
+    this->nbThreads = nbThreads;
+
+    isSource.assign(Color::nbColors(), false);
+
+    for (Color c : sources) {
+
+        isSource[c.toInt()] = true;
+    }
+
+    columnDist.resize(img.getSize());
+    dist.resize(img.getSize());
+
+    update(img);
+}
+
+template <typename T>
+void DistanceMap <T>::update(const Image& img) {
+
+    assert(img.getWidth() == width && img.getHeight() == height);
+
+    // Première passe : chaque fil traite une bande de colonnes, ligne par ligne,
+    // ce qui garde des accès mémoire contigus.
+    parallelFor(0, width, nbThreads, [this, &img](int first, int last) {
+
+        columnPass(img, first, last);
+    });
+
+    // Seconde passe : chaque fil traite une bande de lignes indépendantes.
+    parallelFor(0, height, nbThreads, [this](int first, int last) {
+
+        if (metric == Metric::Euclidean) euclideanRowPass(first, last);
+
+        else manhattanRowPass(first, last);
+    });
+}
+
+template <typename T>
+void DistanceMap <T>::columnPass(const Image& img, int first, int last) {
+
+    // Plus grande que toute distance réelle : marque l'absence de source dans la colonne.
+    const int inf = width + height + 1;
+
+    // Descente : distance à la source la plus proche au-dessus (ou sur) le pixel.
+    for (int j = first; j < last; ++j) {
+
+        columnDist[j] = isSource[img.getPixel(0, j).toInt()] ? 0 : inf;
+    }
+
+    for (int i = 1; i < height; ++i) {
+
+        int* row = &columnDist[i * width];
+        const int* above = row - width;
+
+        for (int j = first; j < last; ++j) {
+
+            if (isSource[img.getPixel(i, j).toInt()]) row[j] = 0;
+
+            else row[j] = (above[j] >= inf) ? inf : above[j] + 1;
+        }
+    }
+
+    // Remontée : prise en compte des sources situées en dessous.
+    for (int i = height - 2; i >= 0; --i) {
+
+        int* row = &columnDist[i * width];
+        const int* below = row + width;
+
+        for (int j = first; j < last; ++j) {
+
+            if (below[j] + 1 < row[j]) row[j] = below[j] + 1;
+        }
+    }
+}
+
+template <typename T>
+void DistanceMap <T>::euclideanRowPass(int first, int last) {
+
+    const int inf = width + height + 1;
+
+    // v contient les colonnes des paraboles de l'enveloppe inférieure,
+    // z les abscisses des frontières entre paraboles consécutives.
+    vector <int> v(width);
+    vector <double> z(width + 1);
+
+    for (int i = first; i < last; ++i) {
+
+        const int* g = &columnDist[i * width];
+        T* out = &dist[i * width];
+
+        int k = -1;
+
+        for (int q = 0; q < width; ++q) {
+
+            // Une colonne sans source ne contribue pas à l'enveloppe.
+            if (g[q] >= inf) continue;
+
+            double fq = static_cast<double>(g[q]) * g[q] + static_cast<double>(q) * q;
+
+            if (k < 0) {
+
+                k = 0;
+                v[0] = q;
+                z[0] = -numeric_limits<double>::infinity();
+                z[1] = numeric_limits<double>::infinity();
+                continue;
+            }
+
+            double s;
+
+            // Les paraboles entièrement cachées par la nouvelle sont retirées.
+            while (true) {
+
+                int p = v[k];
+                double fp = static_cast<double>(g[p]) * g[p] + static_cast<double>(p) * p;
+
+                s = (fq - fp) / (2.0 * (q - p));
+
+                if (s > z[k]) break;
+
+                --k;
+            }
+
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k+1] = numeric_limits<double>::infinity();
+        }
+
+        // Aucune source sur aucune colonne : toute la ligne est hors d'atteinte.
+        if (k < 0) {
+
+            for (int q = 0; q < width; ++q) out[q] = infinity();
+
+            continue;
+        }
+
+        k = 0;
+
+        for (int q = 0; q < width; ++q) {
+
+            while (z[k+1] < q) ++k;
+
+            double dq = q - v[k];
+            double dg = g[v[k]];
+
+            store(out[q], sqrt(dq * dq + dg * dg));
+        }
+    }
+}
+
+template <typename T>
+void DistanceMap <T>::manhattanRowPass(int first, int last) {
+
+    const int inf = width + height + 1;
+
+    vector <int> d(width);
+
+    for (int i = first; i < last; ++i) {
+
+        const int* g = &columnDist[i * width];
+        T* out = &dist[i * width];
+
+        // La distance de Manhattan est séparable : deux balayages de la ligne suffisent.
+        d[0] = g[0];
+
+        for (int q = 1; q < width; ++q) {
+
+            d[q] = min(g[q], d[q-1] + 1);
+        }
+
+        for (int q = width - 2; q >= 0; --q) {
+
+            d[q] = min(d[q], d[q+1] + 1);
+        }
+
+        for (int q = 0; q < width; ++q) {
+
+            if (d[q] >= inf) out[q] = infinity();
+
+            else store(out[q], d[q]);
+        }
+    }
+}
+
+template <typename T>
+int DistanceMap <T>::getWidth() const {
+
+    return width;
+}
+
+template <typename T>
+int DistanceMap <T>::getHeight() const {
+
+    return height;
+}
+
+template <typename T>
+T DistanceMap <T>::getDistance(int i, int j) const {
+
+    assert(0 <= i && i < height && 0 <= j && j < width);
+
+    return dist[i * width + j];
+}
+
+template <typename T>
+const vector <T>& DistanceMap <T>::getData() const {
+
+    return dist;
+}
+
+template class DistanceMap <float>;
+template class DistanceMap <uint16_t>;
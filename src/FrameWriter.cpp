@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include "../head/Metrics.h"
+#include "../head/FrameWriter.h"
+
+FrameWriter::FrameWriter(int nbThreads, int capacity) : capacity(capacity), pending(0), stopping(false) {
+
+    assert(nbThreads >= 1 && capacity >= 1);
+
+    for (int t = 0; t < nbThreads; ++t) {
+
+        threads.emplace_back(&FrameWriter::run, this);
+    }
+}
+
+FrameWriter::~FrameWriter() {
+
+    {
+        unique_lock <mutex> guard(lock);
+
+        allWritten.wait(guard, [this]() { return pending == 0; });
+
+        stopping = true;
+    }
+
+    notEmpty.notify_all();
+
+    for (thread& th : threads) {
+
+        th.join();
+    }
+}
+
+void FrameWriter::writeAIP(const Image& img, const string& filename) {
+
+    push(img, filename, 0);
+}
+
+void FrameWriter::writeSVG(const Image& img, const string& filename, int pixelSize) {
+
+    assert(pixelSize >= 1);
+
+    push(img, filename, pixelSize);
+}
+
+void FrameWriter::flush() {
+
+    unique_lock <mutex> guard(lock);
+
+    allWritten.wait(guard, [this]() { return pending == 0; });
+
+    if (failure) {
+
+        exception_ptr e = failure;
+        failure = nullptr;
+
+        rethrow_exception(e);
+    }
+}
+
+int FrameWriter::nbPending() {
+
+    lock_guard <mutex> guard(lock);
+
+    return pending;
+}
+
+void FrameWriter::push(const Image& img, const string& filename, int pixelSize) {
+
+    // La copie est faite hors du verrou : les fils d'écriture ne l'attendent pas.
+    unique_ptr <Frame> frame(new Frame { Image(img), filename, pixelSize });
+
+    {
+        AIP_TIMER("writer.wait");
+
+        unique_lock <mutex> guard(lock);
+
+        notFull.wait(guard, [this]() { return static_cast<int>(frames.size()) < capacity; });
+
+        frames.push_back(move(frame));
+        ++pending;
+    }
+
+    notEmpty.notify_one();
+
+    AIP_COUNT("writer.frames", 1);
+}
+
+void FrameWriter::run() {
+
+    while (true) {
+
+        unique_ptr <Frame> frame;
+
+        {
+            unique_lock <mutex> guard(lock);
+
+            notEmpty.wait(guard, [this]() { return stopping || !frames.empty(); });
+
+            if (frames.empty()) return;
+
+            frame = move(frames.front());
+            frames.pop_front();
+        }
+
+        notFull.notify_one();
+
+        try {
+
+            if (frame->pixelSize == 0) frame->img.writeAIP(frame->filename);
+
+            else frame->img.writeSVG(frame->filename, frame->pixelSize);
+        }
+        catch (...) {
+
+            lock_guard <mutex> guard(lock);
+
+            if (!failure) failure = current_exception();
+        }
+
+        // L'image est libérée avant d'annoncer la fin de son écriture.
+        frame.reset();
+
+        {
+            lock_guard <mutex> guard(lock);
+
+            if (--pending == 0) allWritten.notify_all();
+        }
+    }
+}
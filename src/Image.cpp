@@ -6,55 +6,46 @@
 /// Les sources de AIP sont distribuées sans aucune garantie.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 #include <cstdlib>
 #include <time.h>
 #include "../head/Image.h"
+#include "../head/PixelGrid.h"
 
-Image::Image(int w, int h) {
+Image::Image(int w, int h, pmr::memory_resource* memory) : pixels(memory) {
 
      assert(w >= 1 && h >= 1);
 
+     // Le nombre de pixels, calculé sur 64 bits, doit tenir dans un int : c'est la taille du bloc.
+     if (static_cast<long long>(w) * h > INT_MAX) throw runtime_error("error image too large");
+
      width = w;
      height = h;
 
-     pixelTab.resize(height); // pixelTab étant un vector de taille non définie à l'avance, cette instruction initialise sa taille.
-
-     for (int i = 0; i < height; ++i) {
-
-          pixelTab[i].resize(width); // De même pour chaque sous-vecteur de pixelTab.
-
-          for (int j = 0; j < width; ++j) {
-
-               pixelTab[i][j] = Color(); // Attribue par défaut la couleur noire.
-          }
-     }
+     // Les pixels sont rangés ligne après ligne dans un seul bloc, alloué par memory.
+     pixels.assign(getSize(), Color()); // Attribue par défaut la couleur noire.
 }
 
-Image::Image(const Image& img) {
+Image::Image(const Image& img, pmr::memory_resource* memory) : pixels(img.pixels, memory) {
 
      width = img.getWidth();
      height = img.getHeight();
-     
-     pixelTab.resize(height);
-
-     for (int i = 0; i < height; ++i) {
-
-          pixelTab[i].resize(width);
+}
 
-          for (int j = 0; j < width; ++j) {
+Image::~Image() {
 
-               pixelTab[i][j] = img.getPixel(i, j);
-          }
-     }
+     pixels.clear(); // Le vecteur est vidé de ses éléments mais prend toujours de la place en mémoire !
+     pixels.shrink_to_fit(); // Le vecteur ne peut être désalloué mais son espace mémoire attribué est désormais de 0.
 }
 
-Image::~Image() {
+pmr::memory_resource* Image::getMemoryResource() const {
 
-     pixelTab.clear(); // Le vecteur est vidé de ses éléments mais prend toujours de la place en mémoire !
-     pixelTab.shrink_to_fit(); // Le vecteur ne peut être désalloué mais son espace mémoire attribué est désormais de 0.
+     return pixels.get_allocator().resource();
 }
 
 bool Image::isValidCoordinate(int i, int j) const {
@@ -81,14 +72,14 @@ Color Image::getPixel(int i, int j) const {
 
      assert(isValidCoordinate(i, j));
 
-     return pixelTab[i][j];
+     return pixels[i * width + j];
 }
 
 void Image::setPixel(int i, int j, Color col) {
      
      assert(isValidCoordinate(i, j));
 
-     pixelTab[i][j] = col;
+     pixels[i * width + j] = col;
 }
 
 void Image::fill(Color col) {
@@ -97,22 +88,14 @@ void Image::fill(Color col) {
 
           for (int j = 0; j < width; ++j) {
 
-               pixelTab[i][j] = col;
+               pixels[i * width + j] = col;
           }
      }
 }
 
-void Image::fillRectangle(int i1, int i2, int j1, int j2, Color col) {
+void Image::fillRectangle(int i1, int j1, int i2, int j2, Color col) {
 
-     assert(isValidCoordinate(i1, j1) && isValidCoordinate(i2, j2));
-
-     for (int i = i1; i <= i2; ++i) {
-          
-          for (int j = j1; j <= j2; ++j) {
-
-               pixelTab[i][j] = col;
-          }
-     }
+     forEachInRect(i1, j1, i2, j2, [col](int, Color& c) { c = col; });
 }
 
 // Le pixel de coordonnées (i, j) est le pixel numéro k = i*w + j.
@@ -140,38 +123,108 @@ bool Image::operator==(const Image &img) const {
      if (width != img.getWidth()) return false;
      if (height != img.getHeight()) return false;
 
-     for (int i = 0; i < height; ++i) {
+     return pixels == img.pixels;
+}
 
-          for (int j = 0; j < width; ++j) {
+bool Image::operator!=(const Image &img) const {
+
+     return !(*this == img);
+}
+
+vector <int> Image::changedPixels(const Image &img) const {
+
+     assert(width == img.getWidth() && height == img.getHeight());
+
+     static_assert(sizeof(Color) == 1, "a pixel is one byte");
+
+     const unsigned char* a = reinterpret_cast<const unsigned char*>(pixels.data());
+     const unsigned char* b = reinterpret_cast<const unsigned char*>(img.pixels.data());
+
+     vector <int> changed;
+
+     int n = getSize();
+     int k = 0;
+
+     // Un paquet de 8 pixels identiques est passé d'une seule comparaison.
+     for (; k + 8 <= n; k += 8) {
+
+          uint64_t x, y;
+
+          memcpy(&x, a + k, 8);
+          memcpy(&y, b + k, 8);
 
-               if (pixelTab[i][j] != img.getPixel(i, j)) return false;
+          if (x == y) continue;
+
+          for (int q = k; q < k + 8; ++q) {
+
+               if (a[q] != b[q]) changed.push_back(q);
           }
      }
 
-     return true;
+     for (; k < n; ++k) {
+
+          if (a[k] != b[k]) changed.push_back(k);
+     }
+
+     return changed;
 }
 
-bool Image::operator!=(const Image &img) const {
+// Mélange un mot de 64 bits dans l'empreinte h (multiplication puis rotation).
+static inline uint64_t mixHash(uint64_t h, uint64_t word) {
+
+     h ^= word * 0x9E3779B97F4A7C15ULL;
+     h = (h << 27) | (h >> 37);
+
+     return h * 0xC2B2AE3D27D4EB4FULL + 0x165667B19E3779F9ULL;
+}
+
+// Les pixels sont regroupés par paquets de 8 (un octet par couleur) pour être mélangés mot par mot.
+uint64_t Image::hash() const {
 
-     if (width != img.getWidth()) return true;
-     if (height != img.getHeight()) return true;
+     uint64_t h = mixHash(0, (static_cast<uint64_t>(width) << 32) | static_cast<uint32_t>(height));
 
      for (int i = 0; i < height; ++i) {
 
-          for (int j= 0; j < width; ++j) {
+          uint64_t word = 0;
+          int filled = 0;
 
-               if (pixelTab[i][j] != img.getPixel(i, j)) return true;
+          for (int j = 0; j < width; ++j) {
+
+               word = (word << 8) | static_cast<uint64_t>(pixels[i * width + j].toInt());
+
+               if (++filled == 8) {
+
+                    h = mixHash(h, word);
+                    word = 0;
+                    filled = 0;
+               }
           }
+
+          // Le reste de la ligne, complété de son nombre de pixels pour distinguer les lignes courtes.
+          h = mixHash(h, (word << 8) | static_cast<uint64_t>(filled));
      }
 
-     return false;
+     // Finalisation : diffusion des derniers bits sur l'ensemble du mot.
+     h ^= h >> 33;
+     h *= 0xFF51AFD7ED558CCDULL;
+     h ^= h >> 33;
+
+     return h;
 }
 
-// Des pixels consécutifs sont des pixels qui se touchent par un de leurs 4 bords.
-bool Image::areConsecutivePixels(int i1, int j1, int i2, int j2) const {
+// Des pixels consécutifs sont des pixels qui se touchent par un de leurs 4 bords,
+// ou aussi par un de leurs 4 coins en 8-connexité.
+bool Image::areConsecutivePixels(int i1, int j1, int i2, int j2, int connectivity) const {
+
+     assert(connectivity == 4 || connectivity == 8);
 
      if (!isValidCoordinate(i1, j1) || !isValidCoordinate(i2, j2)) return false;
 
+     if (connectivity == 8) {
+
+          return (i1 != i2 || j1 != j2) && abs(i1 - i2) <= 1 && abs(j1 - j2) <= 1;
+     }
+
      bool sameRow = false;
      bool sameColumn = false;
      bool consecutiveRow = false;
@@ -205,7 +258,7 @@ Image makeRandomImage(int w, int h) {
      return img;
 }
 
-Image Image::readAIP(const string& filename) {
+Image Image::readAIP(const string& filename, long long maxPixels) {
 
      ifstream file; // Objet qui récupèrera le contenu du fichier.aip.
      int w, h; // w et la largeur et h la hauteur de l'image à créer.
@@ -218,6 +271,11 @@ Image Image::readAIP(const string& filename) {
 
      file >> w >> h; // On récupère les valeurs numériques de w et h, séparées par un espace sur la première ligne de file.
 
+     if (!file || w < 1 || h < 1) throw runtime_error("error bad format (read AIP)");
+
+     // Le nombre de pixels annoncé est vérifié avant toute allocation.
+     if (static_cast<long long>(w) * h > min<long long>(maxPixels, INT_MAX)) throw runtime_error("error bad format (read AIP)");
+
      Image img = Image(w, h);
 
      getline(file, s); // Récupère temporairement la première ligne de file dans s, nécessaire pour passer aux lignes suivantes.
@@ -228,11 +286,16 @@ Image Image::readAIP(const string& filename) {
 
           getline(file, s); // s récupère toutes les lignes de file une par une.
 
+          if (!file || static_cast<int>(s.size()) < img.getWidth()) throw runtime_error("error bad format (read AIP)");
+
           for (int j = 0; j < img.getWidth(); ++j) {
 
+               // Un caractère qui n'est pas le chiffre d'une couleur rend le fichier invalide.
+               if (s[j] < '0' || s[j] >= '0' + Color::nbColors()) throw runtime_error("error bad format (read AIP)");
+
                // Pour convertir le caractère récupéré en entier facilement, on soustrait 
                // à sa valeur celle du caractère '0'. On convertit la valeur en couleur.
-               col = Color::makeColor(s.at(j) - '0');
+               col = Color::makeColor(s[j] - '0');
 
                img.setPixel(i, j, col); // Affectation des couleurs de img.
           }
@@ -247,70 +310,10 @@ Image Image::readAIP(const string& filename) {
 
 void Image::writeAIP(const string& filename) const {
 
-     ofstream file; // Objet dont le contenu sera déposé dans le fichier .aip.
-     file.open(filename + ".aip"); // file est chargé en mémoire et se lie au fichier filename.aip. Le crée s'il n'existe pas.
-
-     if (!file) throw runtime_error("error open file (write AIP)");
-
-     file << getWidth()  // Insère les dimensions de l'image dans la première ligne de file.
-          << " " 
-          << getHeight()
-          << endl;
-
-     // Insère à leurs positions, ligne par ligne et colonne par colonne, les valeurs numériques
-     // correspondant aux couleurs de chaque pixel de l'image.
-     for (int i = 0; i < getHeight(); ++i) { 
-
-          for (int j = 0; j < getWidth(); ++j) {
-
-               file << getPixel(i,j).toInt();
-          }
-
-          file << endl;
-     }
-
-     file.close(); // Détruit l'objet file après avoir inséré son contenu dans la cible filename.aip.
+     writeAIPFile(*this, filename);
 }
 
 void Image::writeSVG(const string& filename, int pixelSize) const {
 
-     assert(pixelSize > 0);
-
-     ofstream file;
-     file.open(filename + ".svg");
-
-     if (!file) throw runtime_error("error open file (write SVG)");
-
-     file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-          << endl
-          << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\""
-          << pixelSize*getWidth()
-          << "\" height=\""
-          << pixelSize*getHeight()
-          << "\">"
-          << endl;
-
-     for (int i = 0; i < getHeight(); ++i) {
-
-          for (int j = 0; j < getWidth(); ++j) {
-
-               file << "<rect width=\""
-                    << pixelSize
-                    << "\" height=\""
-                    << pixelSize
-                    << "\" x=\""
-                    << pixelSize*(j)
-                    << "\" y=\""
-                    << pixelSize*(i)
-                    << "\" fill=\""
-                    << getPixel(i, j)
-                    << "\" />"
-                    << endl;
-          }
-     }
-
-     file << "</svg>"
-          << endl;
-
-     file.close();
+     writeSVGFile(*this, filename, pixelSize);
 }
\ No newline at end of file
@@ -0,0 +1,524 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include "../head/Json.h"
+
+// Profondeur maximale d'imbrication d'un texte lu : une ligne malveillante ne peut épuiser la pile.
+static const int maxDepth = 64;
+
+// Lecteur récursif d'un texte JSON.
+class JsonParser {
+
+public:
+
+    JsonParser(const string& text) : text(text), pos(0) {}
+
+    JsonValue parseDocument() {
+
+        JsonValue v = parseValue(0);
+
+        skipSpaces();
+
+        if (pos != text.size()) fail();
+
+        return v;
+    }
+
+private:
+
+    const string& text;
+    size_t pos;
+
+    [[noreturn]] void fail() const {
+
+        throw runtime_error("error bad format (parse JSON)");
+    }
+
+    void skipSpaces() {
+
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) ++pos;
+    }
+
+    // Consomme le mot word (true, false, null).
+    void expectWord(const char* word) {
+
+        for (; *word; ++word, ++pos) {
+
+            if (pos >= text.size() || text[pos] != *word) fail();
+        }
+    }
+
+    JsonValue parseValue(int depth) {
+
+        if (depth > maxDepth) fail();
+
+        skipSpaces();
+
+        if (pos >= text.size()) fail();
+
+        char c = text[pos];
+
+        if (c == '{') return parseObject(depth);
+        if (c == '[') return parseArray(depth);
+        if (c == '"') return JsonValue(parseString());
+        if (c == 't') { expectWord("true"); return JsonValue(true); }
+        if (c == 'f') { expectWord("false"); return JsonValue(false); }
+        if (c == 'n') { expectWord("null"); return JsonValue(); }
+
+        return parseNumber();
+    }
+
+    JsonValue parseObject(int depth) {
+
+        JsonValue v = JsonValue::object();
+
+        ++pos;
+        skipSpaces();
+
+        if (pos < text.size() && text[pos] == '}') { ++pos; return v; }
+
+        while (true) {
+
+            skipSpaces();
+
+            if (pos >= text.size() || text[pos] != '"') fail();
+
+            string key = parseString();
+
+            skipSpaces();
+
+            if (pos >= text.size() || text[pos] != ':') fail();
+
+            ++pos;
+
+            v.set(key, parseValue(depth + 1));
+
+            skipSpaces();
+
+            if (pos >= text.size()) fail();
+
+            if (text[pos] == '}') { ++pos; return v; }
+
+            if (text[pos] != ',') fail();
+
+            ++pos;
+        }
+    }
+
+    JsonValue parseArray(int depth) {
+
+        JsonValue v = JsonValue::array();
+
+        ++pos;
+        skipSpaces();
+
+        if (pos < text.size() && text[pos] == ']') { ++pos; return v; }
+
+        while (true) {
+
+            v.push(parseValue(depth + 1));
+
+            skipSpaces();
+
+            if (pos >= text.size()) fail();
+
+            if (text[pos] == ']') { ++pos; return v; }
+
+            if (text[pos] != ',') fail();
+
+            ++pos;
+        }
+    }
+
+    // Lit 4 chiffres hexadécimaux.
+    unsigned parseHex() {
+
+        if (pos + 4 > text.size()) fail();
+
+        unsigned code = 0;
+
+        for (int n = 0; n < 4; ++n) {
+
+            char c = text[pos++];
+
+            code *= 16;
+
+            if (c >= '0' && c <= '9') code += c - '0';
+            else if (c >= 'a' && c <= 'f') code += c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') code += c - 'A' + 10;
+            else fail();
+        }
+
+        return code;
+    }
+
+    // Ajoute le caractère code à out, encodé en UTF-8.
+    static void appendUTF8(string& out, unsigned code) {
+
+        if (code < 0x80) out += static_cast<char>(code);
+
+        else if (code < 0x800) {
+
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+
+        else if (code < 0x10000) {
+
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+
+        else {
+
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    string parseString() {
+
+        string s;
+
+        ++pos;
+
+        while (true) {
+
+            if (pos >= text.size()) fail();
+
+            char c = text[pos++];
+
+            if (c == '"') return s;
+
+            if (static_cast<unsigned char>(c) < 0x20) fail();
+
+            if (c != '\\') { s += c; continue; }
+
+            if (pos >= text.size()) fail();
+
+            c = text[pos++];
+
+            switch (c) {
+
+                case '"': s += '"'; break;
+                case '\\': s += '\\'; break;
+                case '/': s += '/'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'n': s += '\n'; break;
+                case 'r': s += '\r'; break;
+                case 't': s += '\t'; break;
+
+                case 'u': {
+
+                    unsigned code = parseHex();
+
+                    // Un caractère hors du plan de base est écrit en deux moitiés (\uD8xx\uDCxx).
+                    if (code >= 0xd800 && code < 0xdc00) {
+
+                        if (pos + 2 > text.size() || text[pos] != '\\' || text[pos + 1] != 'u') fail();
+
+                        pos += 2;
+
+                        unsigned low = parseHex();
+
+                        if (low < 0xdc00 || low >= 0xe000) fail();
+
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+
+                    appendUTF8(s, code);
+                    break;
+                }
+
+                default: fail();
+            }
+        }
+    }
+
+    JsonValue parseNumber() {
+
+        size_t start = pos;
+
+        if (pos < text.size() && text[pos] == '-') ++pos;
+
+        size_t digits = pos;
+
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+
+        if (pos == digits) fail();
+
+        if (pos < text.size() && text[pos] == '.') {
+
+            size_t fraction = ++pos;
+
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+
+            if (pos == fraction) fail();
+        }
+
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+
+            ++pos;
+
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) ++pos;
+
+            size_t exponent = pos;
+
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+
+            if (pos == exponent) fail();
+        }
+
+        return JsonValue(strtod(text.substr(start, pos - start).c_str(), nullptr));
+    }
+};
+
+JsonValue::JsonValue() : type(Null), boolean(false), number(0) {}
+
+JsonValue::JsonValue(bool b) : type(Bool), boolean(b), number(0) {}
+
+JsonValue::JsonValue(int n) : type(Number), boolean(false), number(n) {}
+
+JsonValue::JsonValue(double x) : type(Number), boolean(false), number(x) {}
+
+JsonValue::JsonValue(const string& s) : type(String), boolean(false), number(0), text(s) {}
+
+JsonValue::JsonValue(const char* s) : type(String), boolean(false), number(0), text(s) {}
+
+JsonValue JsonValue::array() {
+
+    JsonValue v;
+
+    v.type = Array;
+
+    return v;
+}
+
+JsonValue JsonValue::object() {
+
+    JsonValue v;
+
+    v.type = Object;
+
+    return v;
+}
+
+JsonValue JsonValue::parse(const string& text) {
+
+    return JsonParser(text).parseDocument();
+}
+
+JsonValue::Type JsonValue::getType() const {
+
+    return type;
+}
+
+bool JsonValue::asBool() const {
+
+    assert(type == Bool);
+
+    return boolean;
+}
+
+double JsonValue::asNumber() const {
+
+    assert(type == Number);
+
+    return number;
+}
+
+const string& JsonValue::asString() const {
+
+    assert(type == String);
+
+    return text;
+}
+
+int JsonValue::size() const {
+
+    assert(type == Array || type == Object);
+
+    return type == Array ? elements.size() : members.size();
+}
+
+const JsonValue& JsonValue::at(int n) const {
+
+    assert(type == Array && 0 <= n && n < static_cast<int>(elements.size()));
+
+    return elements[n];
+}
+
+void JsonValue::push(const JsonValue& value) {
+
+    assert(type == Array);
+
+    elements.push_back(value);
+}
+
+bool JsonValue::has(const string& key) const {
+
+    return get(key).type != Null;
+}
+
+const JsonValue& JsonValue::get(const string& key) const {
+
+    static const JsonValue null;
+
+    assert(type == Object);
+
+    // Les commandes n'ont que quelques membres : une recherche linéaire suffit.
+    for (const pair <string, JsonValue>& m : members) {
+
+        if (m.first == key) return m.second;
+    }
+
+    return null;
+}
+
+void JsonValue::set(const string& key, const JsonValue& value) {
+
+    assert(type == Object);
+
+    for (pair <string, JsonValue>& m : members) {
+
+        if (m.first == key) { m.second = value; return; }
+    }
+
+    members.push_back(make_pair(key, value));
+}
+
+int JsonValue::getInt(const string& key, int fallback) const {
+
+    const JsonValue& v = get(key);
+
+    if (v.type == Null) return fallback;
+
+    if (v.type != Number || v.number != floor(v.number) || fabs(v.number) > 2147483647.0) {
+
+        throw runtime_error("field " + key + " must be an integer");
+    }
+
+    return static_cast<int>(v.number);
+}
+
+string JsonValue::getString(const string& key, const string& fallback) const {
+
+    const JsonValue& v = get(key);
+
+    if (v.type == Null) return fallback;
+
+    if (v.type != String) throw runtime_error("field " + key + " must be a string");
+
+    return v.text;
+}
+
+// Ajoute s entre guillemets à out, avec les caractères spéciaux échappés.
+static void writeString(string& out, const string& s) {
+
+    out += '"';
+
+    for (char c : s) {
+
+        switch (c) {
+
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+
+            default:
+
+                if (static_cast<unsigned char>(c) < 0x20) {
+
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", c);
+                    out += code;
+                }
+
+                else out += c;
+        }
+    }
+
+    out += '"';
+}
+
+void JsonValue::write(string& out) const {
+
+    switch (type) {
+
+        case Null: out += "null"; break;
+
+        case Bool: out += boolean ? "true" : "false"; break;
+
+        case Number: {
+
+            // Les entiers, de loin les plus fréquents, sont écrits sans partie décimale.
+            char digits[32];
+
+            if (number == floor(number) && fabs(number) < 1e15) snprintf(digits, sizeof(digits), "%.0f", number);
+
+            else if (std::isfinite(number)) snprintf(digits, sizeof(digits), "%.17g", number);
+
+            else snprintf(digits, sizeof(digits), "null");
+
+            out += digits;
+            break;
+        }
+
+        case String: writeString(out, text); break;
+
+        case Array:
+
+            out += '[';
+
+            for (size_t n = 0; n < elements.size(); ++n) {
+
+                if (n > 0) out += ',';
+
+                elements[n].write(out);
+            }
+
+            out += ']';
+            break;
+
+        case Object:
+
+            out += '{';
+
+            for (size_t n = 0; n < members.size(); ++n) {
+
+                if (n > 0) out += ',';
+
+                writeString(out, members[n].first);
+                out += ':';
+                members[n].second.write(out);
+            }
+
+            out += '}';
+            break;
+    }
+}
+
+string JsonValue::toString() const {
+
+    string out;
+
+    write(out);
+
+    return out;
+}
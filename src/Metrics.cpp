@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include "../head/Metrics.h"
+
+#ifdef AIP_INSTRUMENT
+
+// Nombre d'allocations dynamiques du programme : les opérateurs new et delete globaux
+// sont remplacés pour les compter.
+static atomic <long long> allocationCount(0);
+
+void* operator new(size_t size) {
+
+    allocationCount.fetch_add(1, memory_order_relaxed);
+
+    void* p = malloc(size == 0 ? 1 : size);
+
+    if (!p) throw bad_alloc();
+
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+
+    free(p);
+}
+
+// Forme alignée, utilisée notamment par la ressource mémoire par défaut (std::pmr).
+void* operator new(size_t size, align_val_t alignment) {
+
+    allocationCount.fetch_add(1, memory_order_relaxed);
+
+    size_t a = static_cast<size_t>(alignment);
+
+    // aligned_alloc exige une taille multiple de l'alignement.
+    void* p = aligned_alloc(a, (size + a - 1) / a * a + (size == 0 ? a : 0));
+
+    if (!p) throw bad_alloc();
+
+    return p;
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+
+    free(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+
+    free(p);
+}
+
+#endif
+
+Metrics::Metrics() {
+
+    for (atomic <long long>& v : values) {
+
+        v.store(0);
+    }
+
+    allocationsAtStep = allocations();
+}
+
+Metrics& Metrics::global() {
+
+    static Metrics metrics;
+
+    return metrics;
+}
+
+int Metrics::counter(const string& name) {
+
+    return slot(name, false);
+}
+
+int Metrics::timer(const string& name) {
+
+    return slot(name, true);
+}
+
+int Metrics::slot(const string& name, bool timer) {
+
+    lock_guard <mutex> guard(lock);
+
+    for (size_t s = 0; s < names.size(); ++s) {
+
+        if (names[s] == name) return s;
+    }
+
+    assert(names.size() < static_cast<size_t>(maxSlots));
+
+    names.push_back(name);
+    isTimer.push_back(timer);
+
+    return names.size() - 1;
+}
+
+void Metrics::add(int slot, long long n) {
+
+    assert(slot >= 0 && slot < maxSlots);
+
+    values[slot].fetch_add(n, memory_order_relaxed);
+}
+
+void Metrics::endStep() {
+
+#ifdef AIP_INSTRUMENT
+    // La case est réservée avant de prendre le verrou, que counter prend aussi.
+    int allocationSlot = counter("allocations");
+#endif
+
+    lock_guard <mutex> guard(lock);
+
+#ifdef AIP_INSTRUMENT
+    // Les allocations de l'étape sont relevées comme un compteur ordinaire; allocationsAtStep
+    // n'est lu et modifié que sous le verrou.
+    add(allocationSlot, allocations() - allocationsAtStep);
+#endif
+
+    vector <long long> row(names.size());
+
+    for (size_t s = 0; s < names.size(); ++s) {
+
+        row[s] = values[s].exchange(0);
+    }
+
+    steps.push_back(row);
+
+    // Le relevé lui-même alloue : l'étape suivante part d'ici.
+    allocationsAtStep = allocations();
+}
+
+int Metrics::nbSteps() const {
+
+    lock_guard <mutex> guard(lock);
+
+    return steps.size();
+}
+
+void Metrics::clear() {
+
+    lock_guard <mutex> guard(lock);
+
+    steps.clear();
+
+    for (atomic <long long>& v : values) {
+
+        v.store(0);
+    }
+
+    allocationsAtStep = allocations();
+}
+
+long long Metrics::allocations() {
+
+#ifdef AIP_INSTRUMENT
+    return allocationCount.load(memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void Metrics::writeCSV(const string& filename) const {
+
+    lock_guard <mutex> guard(lock);
+
+    ofstream file(filename + ".csv");
+
+    if (!file) throw runtime_error("error open file (write CSV)");
+
+    file << "step";
+
+    for (size_t s = 0; s < names.size(); ++s) {
+
+        file << "," << names[s] << (isTimer[s] ? "_ms" : "");
+    }
+
+    file << "\n";
+
+    // Une mesure réservée après une ligne est vide dans celle-ci.
+    for (size_t t = 0; t < steps.size(); ++t) {
+
+        file << t;
+
+        for (size_t s = 0; s < names.size(); ++s) {
+
+            file << ",";
+
+            if (s >= steps[t].size()) continue;
+
+            if (isTimer[s]) file << steps[t][s] / 1e6;
+
+            else file << steps[t][s];
+        }
+
+        file << "\n";
+    }
+
+    if (!file) throw runtime_error("error write file (write CSV)");
+}
+
+void Metrics::writeJSON(const string& filename) const {
+
+    lock_guard <mutex> guard(lock);
+
+    ofstream file(filename + ".json");
+
+    if (!file) throw runtime_error("error open file (write JSON)");
+
+    // Une ligne par étape, comme les résultats du banc d'essai.
+    file << "{\n  \"steps\": [\n";
+
+    for (size_t t = 0; t < steps.size(); ++t) {
+
+        file << "    {\"step\": " << t;
+
+        for (size_t s = 0; s < steps[t].size(); ++s) {
+
+            file << ", \"" << names[s] << (isTimer[s] ? "_ms" : "") << "\": ";
+
+            if (isTimer[s]) file << steps[t][s] / 1e6;
+
+            else file << steps[t][s];
+        }
+
+        file << "}" << (t + 1 < steps.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n}\n";
+
+    if (!file) throw runtime_error("error write file (write JSON)");
+}
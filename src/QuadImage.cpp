@@ -0,0 +1,406 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include "../head/QuadImage.h"
+
+// Retourne la plus petite puissance de 2 supérieure ou égale à n.
+static int powerOfTwo(int n) {
+
+    int p = 1;
+
+    while (p < n) p *= 2;
+
+    return p;
+}
+
+QuadImage::QuadImage(int w, int h, Color col) : width(w), height(h), side(powerOfTwo(w > h ? w : h)) {
+
+    assert(w >= 1 && h >= 1);
+
+    // Le carré est d'abord hors de l'image, puis la partie occupée par l'image est remplie.
+    nodes.push_back({ -1, outside });
+
+    fill(col);
+}
+
+QuadImage::QuadImage(const Image& img)
+    : width(img.getWidth()), height(img.getHeight()), side(powerOfTwo(width > height ? width : height)) {
+
+    nodes.push_back({ -1, outside });
+
+    build(0, img, 0, 0, side);
+}
+
+void QuadImage::build(int n, const Image& img, int i, int j, int size) {
+
+    if (i >= height || j >= width) {
+
+        nodes[n].color = outside;
+        return;
+    }
+
+    if (size == 1) {
+
+        nodes[n].color = img.getPixel(i, j).toInt();
+        return;
+    }
+
+    // Les enfants sont construits puis regroupés s'ils sont uniformes : un groupe libéré sert
+    // aussitôt au bloc voisin, la mémoire reste donc proportionnelle au résultat.
+    int c = allocateBlock(outside);
+    int half = size / 2;
+
+    nodes[n].child = c;
+
+    build(c, img, i, j, half);
+    build(c + 1, img, i, j + half, half);
+    build(c + 2, img, i + half, j, half);
+    build(c + 3, img, i + half, j + half, half);
+
+    tryMerge(n);
+}
+
+Image QuadImage::toImage() const {
+
+    Image img(width, height);
+
+    // Une feuille de l'image ne dépasse jamais de celle-ci : elle serait de deux couleurs.
+    forEachBlock([&img](int i, int j, int size, Color col) {
+
+        img.fillRectangle(i, j, i + size - 1, j + size - 1, col);
+    });
+
+    return img;
+}
+
+int QuadImage::getWidth() const {
+
+    return width;
+}
+
+int QuadImage::getHeight() const {
+
+    return height;
+}
+
+Color QuadImage::getPixel(int i, int j) const {
+
+    assert(0 <= i && i < height && 0 <= j && j < width);
+
+    int n = 0;
+
+    // À chaque niveau, le bit de la moitié du côté choisit le quart qui contient (i, j).
+    for (int half = side / 2; nodes[n].child != -1; half /= 2) {
+
+        n = nodes[n].child + ((i & half) ? 2 : 0) + ((j & half) ? 1 : 0);
+    }
+
+    return Color::makeColor(nodes[n].color);
+}
+
+void QuadImage::setPixel(int i, int j, Color col) {
+
+    assert(0 <= i && i < height && 0 <= j && j < width);
+
+    uint8_t color = col.toInt();
+
+    // Les ancêtres du pixel, pour regrouper ensuite les feuilles redevenues identiques.
+    int path[32];
+    int depth = 0;
+
+    int n = 0;
+
+    for (int half = side / 2; half >= 1; half /= 2) {
+
+        if (nodes[n].child == -1) {
+
+            if (nodes[n].color == color) return;
+
+            split(n);
+        }
+
+        path[depth++] = n;
+
+        n = nodes[n].child + ((i & half) ? 2 : 0) + ((j & half) ? 1 : 0);
+    }
+
+    nodes[n].color = color;
+
+    while (depth > 0 && tryMerge(path[--depth])) {}
+}
+
+void QuadImage::fill(Color col) {
+
+    fillRect(0, 0, 0, side, 0, 0, height - 1, width - 1, col.toInt());
+}
+
+void QuadImage::fillRectangle(int i1, int j1, int i2, int j2, Color col) {
+
+    assert(0 <= i1 && i1 <= i2 && i2 < height);
+    assert(0 <= j1 && j1 <= j2 && j2 < width);
+
+    fillRect(0, 0, 0, side, i1, j1, i2, j2, col.toInt());
+}
+
+void QuadImage::fillRect(int n, int i, int j, int size, int i1, int j1, int i2, int j2, uint8_t color) {
+
+    // Bloc hors du rectangle.
+    if (i > i2 || j > j2 || i + size - 1 < i1 || j + size - 1 < j1) return;
+
+    // Bloc entièrement dans le rectangle : il devient une feuille, sans visiter ses descendants.
+    if (i1 <= i && j1 <= j && i + size - 1 <= i2 && j + size - 1 <= j2) {
+
+        makeLeaf(n, color);
+        return;
+    }
+
+    if (nodes[n].child == -1) {
+
+        if (nodes[n].color == color) return;
+
+        split(n);
+    }
+
+    int c = nodes[n].child;
+    int half = size / 2;
+
+    fillRect(c, i, j, half, i1, j1, i2, j2, color);
+    fillRect(c + 1, i, j + half, half, i1, j1, i2, j2, color);
+    fillRect(c + 2, i + half, j, half, i1, j1, i2, j2, color);
+    fillRect(c + 3, i + half, j + half, half, i1, j1, i2, j2, color);
+
+    tryMerge(n);
+}
+
+int QuadImage::allocateBlock(uint8_t color) {
+
+    int c;
+
+    if (freeBlocks.empty()) {
+
+        c = nodes.size();
+        nodes.resize(c + 4);
+    }
+
+    else {
+
+        c = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+
+    for (int q = 0; q < 4; ++q) {
+
+        nodes[c + q] = { -1, color };
+    }
+
+    return c;
+}
+
+void QuadImage::makeLeaf(int n, uint8_t color) {
+
+    int c = nodes[n].child;
+
+    // Les nœuds libérés sont marqués hors de l'image : ils ne comptent dans aucune zone.
+    if (c != -1) {
+
+        for (int q = 0; q < 4; ++q) {
+
+            makeLeaf(c + q, outside);
+        }
+
+        freeBlocks.push_back(c);
+    }
+
+    nodes[n] = { -1, color };
+}
+
+void QuadImage::split(int n) {
+
+    int c = allocateBlock(nodes[n].color);
+
+    nodes[n].child = c;
+}
+
+bool QuadImage::tryMerge(int n) {
+
+    int c = nodes[n].child;
+
+    for (int q = 0; q < 4; ++q) {
+
+        if (nodes[c + q].child != -1 || nodes[c + q].color != nodes[c].color) return false;
+    }
+
+    makeLeaf(n, nodes[c].color);
+
+    return true;
+}
+
+int QuadImage::nbLeaves() const {
+
+    int leaves = 0;
+
+    for (const Node& node : nodes) {
+
+        if (node.child == -1) ++leaves;
+    }
+
+    // Les groupes libérés sont faits de feuilles.
+    return leaves - 4 * freeBlocks.size();
+}
+
+int QuadImage::nbNodes() const {
+
+    return nodes.size() - 4 * freeBlocks.size();
+}
+
+int QuadImage::nbPixelsOfColor(Color c) const {
+
+    int n = 0;
+
+    forEachBlock([&n, c](int, int, int size, Color col) { if (col == c) n += size * size; });
+
+    return n;
+}
+
+// Les contacts entre feuilles sont énumérés sans descendre jusqu'aux pixels : à l'intérieur
+// d'un nœud, entre deux nœuds voisins par un côté, et autour d'un coin commun à quatre nœuds.
+// Une feuille plus grande que ses voisines tient lieu de chacun de ses quarts.
+
+// Retourne le quart q du nœud n, ou n lui-même si c'est une feuille.
+#define QUARTER(n, q) (nodes[n].child == -1 ? (n) : nodes[n].child + (q))
+
+template <class Link>
+void QuadImage::cellContacts(int n, bool diagonals, Link& link) const {
+
+    int c = nodes[n].child;
+
+    if (c == -1) return;
+
+    for (int q = 0; q < 4; ++q) {
+
+        cellContacts(c + q, diagonals, link);
+    }
+
+    horizontalContacts(c, c + 1, diagonals, link);
+    horizontalContacts(c + 2, c + 3, diagonals, link);
+    verticalContacts(c, c + 2, diagonals, link);
+    verticalContacts(c + 1, c + 3, diagonals, link);
+
+    if (diagonals) cornerContacts(c, c + 1, c + 2, c + 3, link);
+}
+
+template <class Link>
+void QuadImage::horizontalContacts(int left, int right, bool diagonals, Link& link) const {
+
+    if (nodes[left].child == -1 && nodes[right].child == -1) {
+
+        link(left, right);
+        return;
+    }
+
+    int l1 = QUARTER(left, 1), l3 = QUARTER(left, 3);
+    int r0 = QUARTER(right, 0), r2 = QUARTER(right, 2);
+
+    horizontalContacts(l1, r0, diagonals, link);
+    horizontalContacts(l3, r2, diagonals, link);
+
+    if (diagonals) cornerContacts(l1, r0, l3, r2, link);
+}
+
+template <class Link>
+void QuadImage::verticalContacts(int top, int bottom, bool diagonals, Link& link) const {
+
+    if (nodes[top].child == -1 && nodes[bottom].child == -1) {
+
+        link(top, bottom);
+        return;
+    }
+
+    int t2 = QUARTER(top, 2), t3 = QUARTER(top, 3);
+    int b0 = QUARTER(bottom, 0), b1 = QUARTER(bottom, 1);
+
+    verticalContacts(t2, b0, diagonals, link);
+    verticalContacts(t3, b1, diagonals, link);
+
+    if (diagonals) cornerContacts(t2, t3, b0, b1, link);
+}
+
+template <class Link>
+void QuadImage::cornerContacts(int topLeft, int topRight, int bottomLeft, int bottomRight, Link& link) const {
+
+    if (nodes[topLeft].child == -1 && nodes[topRight].child == -1 &&
+        nodes[bottomLeft].child == -1 && nodes[bottomRight].child == -1) {
+
+        link(topLeft, bottomRight);
+        link(topRight, bottomLeft);
+        return;
+    }
+
+    cornerContacts(QUARTER(topLeft, 3), QUARTER(topRight, 2), QUARTER(bottomLeft, 1), QUARTER(bottomRight, 0), link);
+}
+
+#undef QUARTER
+
+vector <int> QuadImage::zonesPerColor(int connectivity) const {
+
+    assert(connectivity == 4 || connectivity == 8);
+
+    // Union-find sur les indices des feuilles.
+    vector <int> parent(nodes.size());
+
+    for (size_t n = 0; n < nodes.size(); ++n) {
+
+        parent[n] = n;
+    }
+
+    auto find = [&parent](int n) {
+
+        while (parent[n] != n) n = parent[n] = parent[parent[n]];
+
+        return n;
+    };
+
+    auto link = [&](int a, int b) {
+
+        if (nodes[a].color != nodes[b].color || nodes[a].color == outside) return;
+
+        a = find(a);
+        b = find(b);
+
+        if (a != b) parent[a] = b;
+    };
+
+    cellContacts(0, connectivity == 8, link);
+
+    vector <int> zones(Color::nbColors(), 0);
+
+    for (size_t n = 0; n < nodes.size(); ++n) {
+
+        if (nodes[n].child == -1 && nodes[n].color != outside && find(n) == static_cast<int>(n)) ++zones[nodes[n].color];
+    }
+
+    return zones;
+}
+
+int QuadImage::nbZonesOfColor(Color c, int connectivity) const {
+
+    return zonesPerColor(connectivity)[c.toInt()];
+}
+
+int QuadImage::nbZones(int connectivity) const {
+
+    int n = 0;
+
+    for (int z : zonesPerColor(connectivity)) {
+
+        n += z;
+    }
+
+    return n;
+}
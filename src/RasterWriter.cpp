@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+#include "../head/Metrics.h"
+#include "../head/ThreadPool.h"
+#include "../head/RasterWriter.h"
+
+// Taille maximale des données d'un bloc deflate stocké.
+static const size_t maxStoredBlock = 65535;
+
+// Ajoute l'entier n à la fin de out, sur 4 octets, poids fort en premier (ordre du PNG).
+static void appendBigEndian(string& out, uint32_t n) {
+
+    out += static_cast<char>(n >> 24);
+    out += static_cast<char>(n >> 16);
+    out += static_cast<char>(n >> 8);
+    out += static_cast<char>(n);
+}
+
+// Retourne le CRC-32 des size octets de data, celui qui termine chaque bloc d'un PNG.
+static uint32_t crc32(const char* data, size_t size) {
+
+    // La table des restes de chaque octet est calculée une fois, au premier appel.
+    static const vector <uint32_t> table = []() {
+
+        vector <uint32_t> t(256);
+
+        for (uint32_t n = 0; n < 256; ++n) {
+
+            uint32_t c = n;
+
+            for (int bit = 0; bit < 8; ++bit) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+
+            t[n] = c;
+        }
+
+        return t;
+    }();
+
+    uint32_t c = 0xffffffffu;
+
+    for (size_t n = 0; n < size; ++n) {
+
+        c = table[(c ^ static_cast<uint8_t>(data[n])) & 0xff] ^ (c >> 8);
+    }
+
+    return c ^ 0xffffffffu;
+}
+
+// Retourne la somme Adler-32 des données, celle qui termine un flux zlib.
+static uint32_t adler32(const string& data) {
+
+    const uint32_t base = 65521;
+
+    uint32_t a = 1, b = 0;
+
+    // 5552 octets au plus entre deux réductions : b ne peut dépasser 32 bits.
+    for (size_t start = 0; start < data.size(); start += 5552) {
+
+        size_t end = min(data.size(), start + 5552);
+
+        for (size_t n = start; n < end; ++n) {
+
+            a += static_cast<uint8_t>(data[n]);
+            b += a;
+        }
+
+        a %= base;
+        b %= base;
+    }
+
+    return (b << 16) | a;
+}
+
+// Commence un bloc PNG de type type et de length octets de données. Retourne la position
+// du type dans png, d'où part le CRC calculé par endChunk.
+static size_t beginChunk(string& png, const char* type, size_t length) {
+
+    appendBigEndian(png, length);
+
+    size_t start = png.size();
+
+    png.append(type, 4);
+
+    return start;
+}
+
+// Termine le bloc PNG commencé à start par son CRC.
+static void endChunk(string& png, size_t start) {
+
+    appendBigEndian(png, crc32(png.data() + start, png.size() - start));
+}
+
+RasterWriter::RasterWriter(int pixelSize) : pixelSize(pixelSize), palette(3 * Color::nbColors(), 0) {
+
+    assert(pixelSize >= 1);
+
+    // Les couleurs nommées de writeSVG.
+    setColor(Color::Black, 0, 0, 0);
+    setColor(Color::White, 255, 255, 255);
+    setColor(Color::Red, 255, 0, 0);
+    setColor(Color::Blue, 0, 0, 255);
+    setColor(Color::Green, 0, 128, 0);
+}
+
+void RasterWriter::setColor(Color c, uint8_t red, uint8_t green, uint8_t blue) {
+
+    palette[3 * c.toInt()] = red;
+    palette[3 * c.toInt() + 1] = green;
+    palette[3 * c.toInt() + 2] = blue;
+}
+
+int RasterWriter::getPixelSize() const {
+
+    return pixelSize;
+}
+
+string RasterWriter::encodePPM(const Image& img) const {
+
+    AIP_TIMER("raster.ppm");
+
+    int w = img.getWidth() * pixelSize;
+    int h = img.getHeight() * pixelSize;
+
+    // Les octets d'un carré de pixels de chaque couleur sur une ligne, copiés d'un bloc.
+    size_t block = 3 * pixelSize;
+    vector <char> lut(block * Color::nbColors());
+
+    for (int c = 0; c < Color::nbColors(); ++c) {
+
+        for (int n = 0; n < pixelSize; ++n) copy_n(&palette[3 * c], 3, &lut[c * block + 3 * n]);
+    }
+
+    string out = "P6\n" + to_string(w) + " " + to_string(h) + "\n255\n";
+
+    out.reserve(out.size() + 3 * static_cast<size_t>(w) * h);
+
+    string row(3 * static_cast<size_t>(w), '\0');
+
+    for (int i = 0, k = 0; i < img.getHeight(); ++i) {
+
+        for (size_t pos = 0; pos < row.size(); pos += block, ++k) {
+
+            copy_n(&lut[img.getPixel(k).toInt() * block], block, &row[pos]);
+        }
+
+        // Une ligne de l'image donne pixelSize lignes identiques.
+        for (int n = 0; n < pixelSize; ++n) out += row;
+    }
+
+    AIP_COUNT("raster.bytes", out.size());
+
+    return out;
+}
+
+string RasterWriter::encodePNG(const Image& img) const {
+
+    AIP_TIMER("raster.png");
+
+    int w = img.getWidth() * pixelSize;
+    int h = img.getHeight() * pixelSize;
+
+    // Les lignes de l'image agrandie, chacune précédée de son filtre (0 : aucun), un octet
+    // par pixel : l'identifiant de sa couleur, qui est aussi son rang dans la palette.
+    string row(1 + static_cast<size_t>(w), '\0');
+    string raw;
+
+    raw.reserve(row.size() * h);
+
+    for (int i = 0, k = 0; i < img.getHeight(); ++i) {
+
+        for (size_t pos = 1; pos < row.size(); pos += pixelSize, ++k) {
+
+            fill_n(&row[pos], pixelSize, static_cast<char>(img.getPixel(k).toInt()));
+        }
+
+        for (int n = 0; n < pixelSize; ++n) raw += row;
+    }
+
+    size_t nbBlocks = max<size_t>(1, (raw.size() + maxStoredBlock - 1) / maxStoredBlock);
+
+    string png = "\x89PNG\r\n\x1a\n";
+
+    png.reserve(png.size() + 25 + 12 + palette.size() + 12 + 6 + 5 * nbBlocks + raw.size() + 12);
+
+    // En-tête : dimensions, 8 bits par pixel, couleurs indexées (3), sans entrelacement.
+    size_t start = beginChunk(png, "IHDR", 13);
+
+    appendBigEndian(png, w);
+    appendBigEndian(png, h);
+    png += '\x08';
+    png += '\x03';
+    png.append(3, '\0');
+    endChunk(png, start);
+
+    start = beginChunk(png, "PLTE", palette.size());
+    png.append(palette.begin(), palette.end());
+    endChunk(png, start);
+
+    // Flux zlib sans compression : en-tête, blocs stockés d'au plus 65535 octets, somme Adler-32.
+    start = beginChunk(png, "IDAT", 2 + 5 * nbBlocks + raw.size() + 4);
+
+    png += '\x78';
+    png += '\x01';
+
+    for (size_t b = 0; b < nbBlocks; ++b) {
+
+        size_t pos = b * maxStoredBlock;
+        size_t len = min(maxStoredBlock, raw.size() - pos);
+
+        png += static_cast<char>(b + 1 == nbBlocks ? 1 : 0); // Dernier bloc, type 0 (stocké).
+        png += static_cast<char>(len & 0xff);
+        png += static_cast<char>(len >> 8);
+        png += static_cast<char>(~len & 0xff);
+        png += static_cast<char>((~len >> 8) & 0xff);
+        png.append(raw, pos, len);
+    }
+
+    appendBigEndian(png, adler32(raw));
+    endChunk(png, start);
+
+    start = beginChunk(png, "IEND", 0);
+    endChunk(png, start);
+
+    AIP_COUNT("raster.bytes", png.size());
+
+    return png;
+}
+
+void RasterWriter::writeFile(const string& content, const string& name, const string& format) {
+
+    ofstream file(name, ios::binary);
+
+    if (!file) throw runtime_error("error open file (write " + format + ")");
+
+    file.write(content.data(), content.size());
+
+    if (!file) throw runtime_error("error open file (write " + format + ")");
+}
+
+void RasterWriter::writePPM(const Image& img, const string& filename) const {
+
+    writeFile(encodePPM(img), filename + ".ppm", "PPM");
+}
+
+void RasterWriter::writePNG(const Image& img, const string& filename) const {
+
+    writeFile(encodePNG(img), filename + ".png", "PNG");
+}
+
+void RasterWriter::write(const Image& img, const string& filename, Format format) const {
+
+    if (format == PPM) writePPM(img, filename);
+
+    else writePNG(img, filename);
+}
+
+void RasterWriter::writeSequence(const vector <Image>& frames, const string& prefix, Format format, int nbThreads) const {
+
+    ThreadPool pool(nbThreads);
+
+    // Une tâche par image : chacune encode et écrit son fichier sans rien partager avec les autres.
+    for (size_t n = 0; n < frames.size(); ++n) {
+
+        pool.submit([this, &frames, &prefix, format, n]() { write(frames[n], prefix + to_string(n), format); });
+    }
+
+    pool.wait();
+}
+
+string RasterWriter::extension(Format format) {
+
+    return format == PPM ? ".ppm" : ".png";
+}
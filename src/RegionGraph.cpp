@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include "../head/RegionGraph.h"
+
+RegionGraph::RegionGraph() {
+
+    offsets.push_back(0);
+}
+
+RegionGraph::RegionGraph(const vector <Color>& colors, vector <pair <int, int>>& contacts) {
+
+    int n = colors.size();
+
+    nodeColor = colors;
+
+    // Chaque contact est orienté de la plus petite zone vers la plus grande, puis les contacts
+    // sont triés : ceux d'une même paire de zones se retrouvent ainsi côte à côte.
+    for (pair <int, int>& c : contacts) {
+
+        assert(c.first != c.second);
+
+        if (c.first > c.second) swap(c.first, c.second);
+    }
+
+    sort(contacts.begin(), contacts.end());
+
+    // Comptage des voisins de chaque zone, une arête comptant pour ses deux extrémités.
+    offsets.assign(n + 1, 0);
+
+    for (size_t e = 0; e < contacts.size(); ++e) {
+
+        if (e > 0 && contacts[e] == contacts[e-1]) continue;
+
+        ++offsets[contacts[e].first + 1];
+        ++offsets[contacts[e].second + 1];
+    }
+
+    for (int z = 0; z < n; ++z) {
+
+        offsets[z+1] += offsets[z];
+    }
+
+    neighbours.resize(offsets[n]);
+    lengths.resize(offsets[n]);
+
+    // Position d'écriture courante dans la liste de chaque zone.
+    vector <int> next(offsets.begin(), offsets.end() - 1);
+
+    // Les arêtes sont parcourues dans l'ordre croissant : la liste de chaque zone
+    // reçoit d'abord ses voisins plus petits puis ses voisins plus grands, et reste donc triée.
+    size_t e = 0;
+
+    while (e < contacts.size()) {
+
+        int z1 = contacts[e].first;
+        int z2 = contacts[e].second;
+        int length = 0;
+
+        while (e < contacts.size() && contacts[e].first == z1 && contacts[e].second == z2) {
+
+            ++length;
+            ++e;
+        }
+
+        neighbours[next[z1]] = z2;
+        lengths[next[z1]++] = length;
+
+        neighbours[next[z2]] = z1;
+        lengths[next[z2]++] = length;
+    }
+}
+
+int RegionGraph::nbNodes() const {
+
+    return nodeColor.size();
+}
+
+int RegionGraph::nbEdges() const {
+
+    return neighbours.size() / 2;
+}
+
+Color RegionGraph::getColor(int z) const {
+
+    assert(z >= 0 && z < nbNodes());
+
+    return nodeColor[z];
+}
+
+int RegionGraph::degree(int z) const {
+
+    assert(z >= 0 && z < nbNodes());
+
+    return offsets[z+1] - offsets[z];
+}
+
+int RegionGraph::neighbour(int z, int n) const {
+
+    assert(n >= 0 && n < degree(z));
+
+    return neighbours[offsets[z] + n];
+}
+
+int RegionGraph::borderLength(int z, int n) const {
+
+    assert(n >= 0 && n < degree(z));
+
+    return lengths[offsets[z] + n];
+}
+
+int RegionGraph::sharedBorder(int z1, int z2) const {
+
+    assert(z1 >= 0 && z1 < nbNodes() && z2 >= 0 && z2 < nbNodes());
+
+    // Les voisins de z1 étant triés, une recherche dichotomique suffit.
+    vector <int>::const_iterator first = neighbours.begin() + offsets[z1];
+    vector <int>::const_iterator last = neighbours.begin() + offsets[z1+1];
+    vector <int>::const_iterator it = lower_bound(first, last, z2);
+
+    if (it == last || *it != z2) return 0;
+
+    return lengths[it - neighbours.begin()];
+}
+
+bool RegionGraph::areAdjacent(int z1, int z2) const {
+
+    return sharedBorder(z1, z2) > 0;
+}
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "../head/CounterRandom.h"
+#include "../head/Parallel.h"
+#include "../head/TerrainGenerator.h"
+
+// Valeur pseudo-aléatoire dans [0, 1) attachée au nœud (x, y) de la grille d'une octave.
+static inline float latticeValue(uint32_t seed, int x, int y) {
+
+    uint32_t h = mixBits(seed ^ mixBits(static_cast<uint32_t>(x) * 0x9E3779B1u ^ mixBits(static_cast<uint32_t>(y))));
+
+    return (h >> 8) * (1.0f / 16777216.0f);
+}
+
+// Interpolation douce entre deux nœuds, sans cassure visible aux bords des cellules.
+static inline float smooth(float t) {
+
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Description d'une octave : pas de la grille, poids, graine et décalage de la grille.
+struct Octave {
+
+    int cell;
+    float weight;
+    uint32_t seed;
+    int offsetX, offsetY;
+
+    // Poids d'interpolation horizontale de chaque position dans une cellule.
+    vector <float> ramp;
+};
+
+// Prépare les octaves d'un champ de bruit de taille de motif featureSize.
+static vector <Octave> makeOctaves(const TerrainParameters& p, int featureSize, uint32_t fieldSeed) {
+
+    vector <Octave> octaves;
+
+    float weight = 1.0f;
+    float total = 0.0f;
+
+    for (int o = 0; o < max(1, p.octaves); ++o) {
+
+        Octave oct;
+
+        oct.cell = max(1, featureSize >> o);
+        oct.weight = weight;
+        oct.seed = mixBits(fieldSeed + 0x632BE5ABu * (o + 1));
+
+        // Chaque octave est décalée pour que les nœuds des différentes grilles ne s'alignent pas.
+        oct.offsetX = mixBits(oct.seed + 1) % oct.cell;
+        oct.offsetY = mixBits(oct.seed + 2) % oct.cell;
+
+        for (int r = 0; r < oct.cell; ++r) {
+
+            oct.ramp.push_back(smooth(static_cast<float>(r) / oct.cell));
+        }
+
+        total += weight;
+        weight *= static_cast<float>(p.persistence);
+
+        octaves.push_back(oct);
+    }
+
+    // Les poids sont normalisés pour que le champ reste dans [0, 1).
+    for (Octave& oct : octaves) {
+
+        oct.weight /= total;
+    }
+
+    return octaves;
+}
+
+// Calcule la valeur du champ sur toute la ligne y. Les nœuds de la grille ne sont évalués
+// qu'une fois par cellule traversée : le coût par pixel est celui d'une interpolation.
+static void fieldRow(const vector <Octave>& octaves, int y, float* row, int w) {
+
+    fill(row, row + w, 0.0f);
+
+    for (const Octave& oct : octaves) {
+
+        int ys = y + oct.offsetY;
+        int cy = ys / oct.cell;
+        float fy = oct.ramp[ys % oct.cell];
+
+        int xs = oct.offsetX;
+        int cx = xs / oct.cell;
+        int r = xs % oct.cell;
+
+        // Valeurs de la ligne interpolées verticalement aux deux bords de la cellule courante.
+        float a0 = latticeValue(oct.seed, cx, cy) * (1 - fy) + latticeValue(oct.seed, cx, cy + 1) * fy;
+        float a1 = latticeValue(oct.seed, cx + 1, cy) * (1 - fy) + latticeValue(oct.seed, cx + 1, cy + 1) * fy;
+
+        for (int x = 0; x < w; ++x) {
+
+            row[x] += oct.weight * (a0 + (a1 - a0) * oct.ramp[r]);
+
+            if (++r == oct.cell) {
+
+                r = 0;
+                ++cx;
+                a0 = a1;
+                a1 = latticeValue(oct.seed, cx + 1, cy) * (1 - fy) + latticeValue(oct.seed, cx + 1, cy + 1) * fy;
+            }
+        }
+    }
+}
+
+// Valeur du champ en un seul point, identique à celle calculée par fieldRow.
+static float fieldValue(const vector <Octave>& octaves, int x, int y) {
+
+    float v = 0.0f;
+
+    for (const Octave& oct : octaves) {
+
+        int xs = x + oct.offsetX;
+        int ys = y + oct.offsetY;
+        int cx = xs / oct.cell;
+        int cy = ys / oct.cell;
+        float fx = oct.ramp[xs % oct.cell];
+        float fy = oct.ramp[ys % oct.cell];
+
+        float a0 = latticeValue(oct.seed, cx, cy) * (1 - fy) + latticeValue(oct.seed, cx, cy + 1) * fy;
+        float a1 = latticeValue(oct.seed, cx + 1, cy) * (1 - fy) + latticeValue(oct.seed, cx + 1, cy + 1) * fy;
+
+        v += oct.weight * (a0 + (a1 - a0) * fx);
+    }
+
+    return v;
+}
+
+// Retourne le seuil sous lequel se trouve la proportion ratio des valeurs de samples (trié).
+static float quantile(const vector <float>& samples, double ratio) {
+
+    if (samples.empty() || ratio <= 0) return -1.0f;
+    if (ratio >= 1) return 2.0f;
+
+    return samples[static_cast<size_t>(ratio * (samples.size() - 1))];
+}
+
+Image makeTerrainImage(int w, int h, const TerrainParameters& p) {
+
+    assert(p.featureSize >= 1 && p.urbanFeatureSize >= 1);
+    assert(p.waterRatio >= 0 && p.urbanRatio >= 0 && p.waterRatio + p.urbanRatio <= 1);
+
+    vector <Octave> relief = makeOctaves(p, p.featureSize, mixBits(p.seed));
+    vector <Octave> urban = makeOctaves(p, p.urbanFeatureSize, mixBits(p.seed ^ 0xB5297A4Du));
+
+    // Les seuils sont estimés sur une grille régulière d'au plus 128x128 points de l'image,
+    // pour atteindre les proportions demandées quelle que soit la forme du bruit.
+    int sx = min(w, 128);
+    int sy = min(h, 128);
+
+    vector <float> reliefSamples;
+    vector <pair <float, float>> samples;
+
+    for (int a = 0; a < sy; ++a) {
+
+        for (int b = 0; b < sx; ++b) {
+
+            int x = static_cast<int>(static_cast<long long>(b) * w / sx);
+            int y = static_cast<int>(static_cast<long long>(a) * h / sy);
+
+            float r = fieldValue(relief, x, y);
+
+            reliefSamples.push_back(r);
+            samples.push_back(make_pair(r, fieldValue(urban, x, y)));
+        }
+    }
+
+    sort(reliefSamples.begin(), reliefSamples.end());
+
+    float waterLevel = quantile(reliefSamples, p.waterRatio);
+
+    // La ville est prise parmi les terres émergées : son seuil se calcule sur celles-ci seulement.
+    vector <float> landSamples;
+
+    for (const pair <float, float>& s : samples) {
+
+        if (s.first >= waterLevel) landSamples.push_back(s.second);
+    }
+
+    sort(landSamples.begin(), landSamples.end());
+
+    double land = 1.0 - p.waterRatio;
+    float urbanLevel = (land <= 0) ? 2.0f : quantile(landSamples, 1.0 - p.urbanRatio / land);
+
+    if (p.urbanRatio <= 0) urbanLevel = 2.0f;
+
+    Image img(w, h);
+
+    // Chaque fil remplit une bande de lignes; le résultat ne dépend que des coordonnées des pixels.
+    parallelFor(0, h, p.nbThreads, [&](int first, int last) {
+
+        vector <float> reliefRow(w);
+        vector <float> urbanRow(w);
+
+        for (int y = first; y < last; ++y) {
+
+            fieldRow(relief, y, reliefRow.data(), w);
+            fieldRow(urban, y, urbanRow.data(), w);
+
+            for (int x = 0; x < w; ++x) {
+
+                Color c = Color::Green;
+
+                if (reliefRow[x] < waterLevel) c = Color::Blue;
+
+                else if (urbanRow[x] > urbanLevel) c = Color::White;
+
+                img.setPixel(y, x, c);
+            }
+        }
+    });
+
+    return img;
+}
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "../head/Parallel.h"
+#include "../head/ThreadPool.h"
+
+// Le groupe et le numéro du fil courant, s'il appartient à un groupe.
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+ThreadPool::ThreadPool(int nbThreads) : queued(0), pending(0), nextWorker(0), stopping(false) {
+
+    nbThreads = defaultThreadCount(nbThreads);
+
+    for (int w = 0; w < nbThreads; ++w) {
+
+        workers.emplace_back(new Worker);
+    }
+
+    // Les fils ne démarrent qu'une fois toutes les files créées : ils peuvent voler dès le début.
+    for (int w = 0; w < nbThreads; ++w) {
+
+        threads.emplace_back(&ThreadPool::run, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        unique_lock <mutex> guard(sleepLock);
+
+        allDone.wait(guard, [this]() { return pending == 0; });
+
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (thread& th : threads) {
+
+        th.join();
+    }
+}
+
+int ThreadPool::size() const {
+
+    return workers.size();
+}
+
+void ThreadPool::submit(function <void()> task) {
+
+    // Depuis un fil du groupe, la tâche reste sur ce fil; sinon, les files sont servies à tour de rôle.
+    int w = (currentPool == this) ? currentWorker : static_cast<int>(nextWorker++ % workers.size());
+
+    ++pending;
+
+    {
+        lock_guard <mutex> guard(workers[w]->lock);
+
+        workers[w]->tasks.push_back(move(task));
+    }
+
+    // Le compteur est modifié sous le verrou de sommeil : un fil qui s'apprête à dormir le voit.
+    {
+        lock_guard <mutex> guard(sleepLock);
+
+        ++queued;
+    }
+
+    wakeUp.notify_one();
+}
+
+void ThreadPool::wait() {
+
+    unique_lock <mutex> guard(sleepLock);
+
+    allDone.wait(guard, [this]() { return pending == 0; });
+
+    if (failure) {
+
+        exception_ptr e = failure;
+        failure = nullptr;
+
+        rethrow_exception(e);
+    }
+}
+
+bool ThreadPool::take(int w, function <void()>& task) {
+
+    int n = workers.size();
+
+    // La file du fil est parcourue par la fin, les autres par le début.
+    for (int d = 0; d < n; ++d) {
+
+        Worker& worker = *workers[(w + d) % n];
+
+        lock_guard <mutex> guard(worker.lock);
+
+        if (worker.tasks.empty()) continue;
+
+        if (d == 0) {
+
+            task = move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+
+        else {
+
+            task = move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+
+        --queued;
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::run(int w) {
+
+    currentPool = this;
+    currentWorker = w;
+
+    function <void()> task;
+
+    while (true) {
+
+        if (!take(w, task)) {
+
+            unique_lock <mutex> guard(sleepLock);
+
+            wakeUp.wait(guard, [this]() { return stopping || queued > 0; });
+
+            if (stopping && queued == 0) return;
+
+            continue;
+        }
+
+        try {
+
+            task();
+        }
+        catch (...) {
+
+            lock_guard <mutex> guard(sleepLock);
+
+            if (!failure) failure = current_exception();
+        }
+
+        task = nullptr;
+
+        // La dernière tâche terminée réveille wait.
+        if (--pending == 0) {
+
+            lock_guard <mutex> guard(sleepLock);
+
+            allDone.notify_all();
+        }
+    }
+}
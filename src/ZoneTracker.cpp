@@ -0,0 +1,471 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <set>
+#include "../head/Analyst.h"
+#include "../head/Neighbourhood.h"
+#include "../head/ZoneTracker.h"
+
+ZoneTracker::ZoneTracker(const Image& img, int connectivity)
+    : width(img.getWidth()), height(img.getHeight()), connectivity(connectivity), frame(img),
+      borders(width, height) {
+
+    assert(connectivity == 4 || connectivity == 8);
+
+    Analyst a(img, false, connectivity);
+    AnalysisResult result = a.getResult();
+
+    alive = result.nbZones();
+
+    for (int z = 0; z < alive; ++z) {
+
+        zoneAreas.push_back(result.zoneSize(z));
+    }
+
+    labels = move(result.labels);
+    zoneColors = move(result.zoneColors);
+
+    owner.assign(width * height, -1);
+}
+
+template <class Visit>
+void ZoneTracker::forEachNeighbour(int k, Visit visit) const {
+
+    if (connectivity == 8) NeighbourLoop <8>::apply(k, borders[k], width, visit);
+
+    else NeighbourLoop <4>::apply(k, borders[k], width, visit);
+}
+
+TrackingStep ZoneTracker::update(const Image& img) {
+
+    assert(img.getWidth() == width && img.getHeight() == height);
+
+    vector <int> changed = frame.changedPixels(img);
+
+    for (int k : changed) {
+
+        frame.setPixel(k, img.getPixel(k));
+    }
+
+    return apply(changed);
+}
+
+TrackingStep ZoneTracker::update(const Image& img, const vector <int>& candidates) {
+
+    assert(img.getWidth() == width && img.getHeight() == height);
+
+    vector <int> changed;
+
+    // Un pixel présent deux fois n'est retenu qu'une fois : sa couleur est déjà à jour.
+    for (int k : candidates) {
+
+        Color c = img.getPixel(k);
+
+        if (c != frame.getPixel(k)) {
+
+            frame.setPixel(k, c);
+            changed.push_back(k);
+        }
+    }
+
+    return apply(changed);
+}
+
+int ZoneTracker::newZone(Color c) {
+
+    zoneColors.push_back(c);
+    zoneAreas.push_back(0);
+
+    ++alive;
+
+    return zoneColors.size() - 1;
+}
+
+void ZoneTracker::relabel(int k, int from, int to) {
+
+    vector <int> stack = { k };
+
+    labels[k] = to;
+
+    while (!stack.empty()) {
+
+        int p = stack.back();
+        stack.pop_back();
+
+        forEachNeighbour(p, [&](int n) {
+
+            if (labels[n] == from) {
+
+                labels[n] = to;
+                stack.push_back(n);
+            }
+        });
+    }
+}
+
+void ZoneTracker::splitZone(int id, vector <int>& seeds, vector <int>& children) {
+
+    sort(seeds.begin(), seeds.end());
+    seeds.erase(unique(seeds.begin(), seeds.end()), seeds.end());
+
+    // Chaque morceau restant touche un pixel retiré : avec un seul voisin restant, pas de coupure.
+    int m = seeds.size();
+
+    if (m <= 1) return;
+
+    // Un parcours en largeur part de chaque voisin. Les parcours qui se rencontrent forment un
+    // groupe (union-find sur leurs numéros). Les groupes avancent d'un pixel chacun à tour de
+    // rôle : un groupe qui s'épuise a parcouru un morceau détaché, en général le plus petit.
+    vector <vector <int>> visited(m);
+    vector <size_t> head(m, 0);
+    vector <int> parent(m);
+    vector <vector <int>> members(m);
+    vector <bool> finished(m, false);
+
+    for (int s = 0; s < m; ++s) {
+
+        parent[s] = s;
+        members[s].push_back(s);
+        visited[s].push_back(seeds[s]);
+        owner[seeds[s]] = s;
+    }
+
+    auto find = [&parent](int s) {
+
+        while (parent[s] != s) s = parent[s] = parent[parent[s]];
+
+        return s;
+    };
+
+    vector <int> active(m);
+
+    for (int s = 0; s < m; ++s) active[s] = s;
+
+    int nbActive = m;
+
+    while (nbActive > 1) {
+
+        for (int r : active) {
+
+            if (find(r) != r || finished[r]) continue;
+
+            // La file du dernier parcours du groupe qui n'est pas épuisé.
+            vector <int>& group = members[r];
+
+            while (!group.empty() && head[group.back()] == visited[group.back()].size()) group.pop_back();
+
+            if (group.empty()) {
+
+                finished[r] = true;
+                --nbActive;
+
+                continue;
+            }
+
+            int s = group.back();
+            int p = visited[s][head[s]++];
+
+            forEachNeighbour(p, [&](int n) {
+
+                if (labels[n] != id) return;
+
+                if (owner[n] == -1) {
+
+                    owner[n] = s;
+                    visited[s].push_back(n);
+
+                    return;
+                }
+
+                int o = find(owner[n]);
+
+                if (o != r) {
+
+                    // Les plus petites listes de parcours sont ajoutées aux plus grandes.
+                    parent[o] = r;
+
+                    if (members[o].size() > group.size()) members[o].swap(group);
+
+                    group.insert(group.end(), members[o].begin(), members[o].end());
+                    members[o].clear();
+
+                    --nbActive;
+                }
+            });
+        }
+
+        active.erase(remove_if(active.begin(), active.end(),
+                               [&](int r) { return find(r) != r || finished[r]; }), active.end());
+    }
+
+    // Les pixels de chaque groupe : tous ceux de ses parcours.
+    map <int, vector <int>> pieces;
+
+    for (int s = 0; s < m; ++s) {
+
+        vector <int>& piece = pieces[find(s)];
+
+        piece.insert(piece.end(), visited[s].begin(), visited[s].end());
+
+        for (int p : visited[s]) owner[p] = -1;
+    }
+
+    // Le groupe encore actif est le reste de la zone et garde son identifiant. Si tous les
+    // groupes se sont épuisés, c'est le plus grand qui le garde.
+    int keep = -1;
+
+    for (const pair <const int, vector <int>>& piece : pieces) {
+
+        if (!finished[piece.first]) keep = piece.first;
+    }
+
+    if (keep == -1) {
+
+        for (const pair <const int, vector <int>>& piece : pieces) {
+
+            if (keep == -1 || piece.second.size() > pieces[keep].size()) keep = piece.first;
+        }
+    }
+
+    for (const pair <const int, vector <int>>& piece : pieces) {
+
+        if (piece.first == keep) continue;
+
+        int child = newZone(zoneColors[id]);
+
+        for (int p : piece.second) labels[p] = child;
+
+        zoneAreas[child] = piece.second.size();
+        zoneAreas[id] -= piece.second.size();
+
+        children.push_back(child);
+    }
+}
+
+TrackingStep ZoneTracker::apply(const vector <int>& changed) {
+
+    TrackingStep step;
+
+    step.changedPixels = changed.size();
+
+    // Les identifiants attribués pendant cette étape sont au moins firstNew.
+    int firstNew = zoneAreas.size();
+
+    // La taille avant l'étape de chaque zone existante touchée.
+    map <int, int> before;
+
+    auto touch = [&](int id) { if (id < firstNew) before.emplace(id, zoneAreas[id]); };
+
+    // 1. Les pixels qui changent de couleur quittent leur zone.
+    for (int k : changed) {
+
+        int id = labels[k];
+
+        touch(id);
+
+        --zoneAreas[id];
+        labels[k] = -1;
+    }
+
+    // 2. Une zone qui a perdu des pixels est peut-être coupée : on le vérifie à partir
+    // des pixels restants voisins des pixels retirés.
+    map <int, vector <int>> seeds;
+
+    for (int k : changed) {
+
+        forEachNeighbour(k, [&](int n) { if (labels[n] >= 0 && before.count(labels[n])) seeds[labels[n]].push_back(n); });
+    }
+
+    set <int> splitChildren;
+    map <int, vector <int>> splits;
+
+    for (pair <const int, vector <int>>& s : seeds) {
+
+        vector <int> children;
+
+        splitZone(s.first, s.second, children);
+
+        if (!children.empty()) {
+
+            splits[s.first] = children;
+            splitChildren.insert(children.begin(), children.end());
+        }
+    }
+
+    // 3. Les pixels qui ont changé forment, par couleur, de nouveaux morceaux : chacun rejoint
+    // les zones voisines de même couleur, qui sont réunies en la plus grande, ou forme une zone.
+    map <int, vector <int>> merges;
+    set <int> absorbed;
+
+    for (int k : changed) {
+
+        if (labels[k] != -1) continue;
+
+        Color c = frame.getPixel(k);
+
+        vector <int> piece = { k };
+
+        // Les zones voisines du morceau, avec un pixel de chacune.
+        map <int, int> neighbours;
+
+        labels[k] = -2;
+
+        for (size_t p = 0; p < piece.size(); ++p) {
+
+            forEachNeighbour(piece[p], [&](int n) {
+
+                if (labels[n] == -1 && frame.getPixel(n) == c) {
+
+                    labels[n] = -2;
+                    piece.push_back(n);
+                }
+
+                else if (labels[n] >= 0 && zoneColors[labels[n]] == c) neighbours.emplace(labels[n], n);
+            });
+        }
+
+        int target = -1;
+
+        for (const pair <const int, int>& z : neighbours) {
+
+            if (target == -1 || zoneAreas[z.first] > zoneAreas[target]) target = z.first;
+        }
+
+        if (target == -1) target = newZone(c);
+
+        touch(target);
+
+        for (const pair <const int, int>& z : neighbours) {
+
+            if (z.first == target) continue;
+
+            touch(z.first);
+
+            relabel(z.second, z.first, target);
+
+            zoneAreas[target] += zoneAreas[z.first];
+            zoneAreas[z.first] = 0;
+            --alive;
+
+            // Une zone absorbée transmet les zones qu'elle avait elle-même absorbées.
+            vector <int>& list = merges[target];
+
+            list.push_back(z.first);
+
+            if (merges.count(z.first)) {
+
+                list.insert(list.end(), merges[z.first].begin(), merges[z.first].end());
+                merges.erase(z.first);
+            }
+
+            absorbed.insert(z.first);
+        }
+
+        for (int p : piece) labels[p] = target;
+
+        zoneAreas[target] += piece.size();
+    }
+
+    // 4. Bilan. Une zone créée puis absorbée pendant l'étape n'apparaît pas.
+    for (int id = firstNew; id < static_cast<int>(zoneAreas.size()); ++id) {
+
+        if (zoneAreas[id] > 0 && !splitChildren.count(id)) step.births.push_back(id);
+    }
+
+    for (const pair <const int, vector <int>>& s : splits) {
+
+        ZoneSplit split = { s.first, {} };
+
+        for (int child : s.second) {
+
+            if (zoneAreas[child] > 0) split.children.push_back(child);
+        }
+
+        if (!split.children.empty()) step.splits.push_back(split);
+    }
+
+    for (const pair <const int, vector <int>>& m : merges) {
+
+        ZoneMerge merge = { m.first, {} };
+
+        for (int id : m.second) {
+
+            if (id < firstNew) merge.absorbed.push_back(id);
+        }
+
+        sort(merge.absorbed.begin(), merge.absorbed.end());
+
+        if (!merge.absorbed.empty() && zoneAreas[m.first] > 0) step.merges.push_back(merge);
+    }
+
+    for (const pair <const int, int>& b : before) {
+
+        int area = zoneAreas[b.first];
+
+        if (area == 0 && !absorbed.count(b.first)) {
+
+            step.deaths.push_back(b.first);
+            --alive;
+        }
+
+        else if (area > 0 && area != b.second) step.areaChanges.push_back({ b.first, b.second, area });
+    }
+
+    return step;
+}
+
+int ZoneTracker::zoneOf(int i, int j) const {
+
+    assert(0 <= i && i < height && 0 <= j && j < width);
+
+    return labels[i * width + j];
+}
+
+const vector <int>& ZoneTracker::getLabels() const {
+
+    return labels;
+}
+
+int ZoneTracker::nbZones() const {
+
+    return alive;
+}
+
+int ZoneTracker::nbIds() const {
+
+    return zoneAreas.size();
+}
+
+bool ZoneTracker::isAlive(int id) const {
+
+    assert(0 <= id && id < nbIds());
+
+    return zoneAreas[id] > 0;
+}
+
+Color ZoneTracker::zoneColor(int id) const {
+
+    assert(0 <= id && id < nbIds());
+
+    return zoneColors[id];
+}
+
+int ZoneTracker::zoneArea(int id) const {
+
+    assert(0 <= id && id < nbIds());
+
+    return zoneAreas[id];
+}
+
+int ZoneTracker::getConnectivity() const {
+
+    return connectivity;
+}
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+// Analyse par lots de fichiers AIP : chaque fichier est lu puis analysé sur un groupe de
+// fils à vol de travail, et ses statistiques de zones et de couleurs sont écrites en CSV
+// ou en JSON.
+//
+// Utilisation : batch.exe [options] CHEMIN...
+//   CHEMIN             un dossier (tous ses fichiers .aip) ou un fichier AIP
+//   --threads N        nombre de fils d'exécution (autant que de cœurs par défaut)
+//   --connectivity N   voisinage des zones, 4 ou 8 (4 par défaut)
+//   --format F         csv ou json (csv par défaut)
+//   --output FICHIER   fichier de sortie (sortie standard par défaut)
+//
+// Le nombre de fichiers traités et le débit sont affichés sur la sortie d'erreur.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../head/BatchAnalysis.h"
+
+using namespace std;
+
+// Options de la ligne de commande.
+struct Options {
+
+  BatchParameters params;
+  string format = "csv";
+  string output;
+  vector <string> paths;
+};
+
+static Options parseOptions(int argc, char** argv) {
+
+  Options opt;
+
+  for (int a = 1; a < argc; ++a) {
+
+    string arg = argv[a];
+
+    if (arg.compare(0, 2, "--") != 0) {
+
+      opt.paths.push_back(arg);
+      continue;
+    }
+
+    if (a + 1 >= argc) throw runtime_error("missing value for option " + arg);
+
+    string value = argv[++a];
+
+    if (arg == "--threads") opt.params.nbThreads = stoi(value);
+    else if (arg == "--connectivity") opt.params.connectivity = stoi(value);
+    else if (arg == "--format") opt.format = value;
+    else if (arg == "--output") opt.output = value;
+    else throw runtime_error("unknown option " + arg);
+  }
+
+  if (opt.paths.empty()) throw runtime_error("usage: batch.exe [options] PATH...");
+  if (opt.params.connectivity != 4 && opt.params.connectivity != 8) throw runtime_error("connectivity must be 4 or 8");
+  if (opt.format != "csv" && opt.format != "json") throw runtime_error("format must be csv or json");
+
+  return opt;
+}
+
+int main(int argc, char** argv) {
+
+  try {
+
+    Options opt = parseOptions(argc, argv);
+
+    vector <string> names;
+
+    for (const string& path : opt.paths) {
+
+      vector <string> found = listAIPFiles(path);
+      names.insert(names.end(), found.begin(), found.end());
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    vector <FileReport> reports = analyseFiles(names, opt.params);
+
+    double seconds = chrono::duration <double>(chrono::steady_clock::now() - start).count();
+
+    ofstream file;
+
+    if (!opt.output.empty()) {
+
+      file.open(opt.output);
+
+      if (!file) throw runtime_error("error open file (write report)");
+    }
+
+    ostream& out = opt.output.empty() ? cout : file;
+
+    if (opt.format == "csv") writeReportsCSV(out, reports);
+
+    else writeReportsJSON(out, reports);
+
+    int failures = 0;
+
+    for (const FileReport& r : reports) {
+
+      if (!r.error.empty()) ++failures;
+    }
+
+    fprintf(stderr, "%zu fichier(s) analysé(s) en %.3f s (%.1f fichiers/s), %d échec(s)\n",
+            reports.size(), seconds, seconds > 0 ? reports.size() / seconds : 0.0, failures);
+
+    return failures == 0 ? 0 : 2;
+  }
+  catch (const exception& e) {
+
+    cerr << e.what() << endl;
+    return 1;
+  }
+}
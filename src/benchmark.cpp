@@ -0,0 +1,475 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+// Banc d'essai des opérations principales du projet sur des images synthétiques
+// de 64x64 à 16384x16384 pixels.
+//
+// Utilisation : bench.exe [options]
+//   --min-size N     plus petit côté d'image testé (64 par défaut)
+//   --max-size N     plus grand côté d'image testé (16384 par défaut)
+//   --reps N         nombre de mesures par cas (7 par défaut)
+//   --warmup N       nombre d'exécutions non mesurées avant les mesures (1 par défaut)
+//   --filter TEXTE   ne lance que les cas dont le nom contient TEXTE
+//   --json FICHIER   fichier de résultats JSON (bench.json par défaut)
+//   --baseline FICHIER  compare les médianes à un fichier JSON d'une version précédente
+//   --threshold P    écart relatif, en pourcents, signalé comme régression (10 par défaut)
+//   --tmp DOSSIER    dossier des fichiers temporaires d'entrée/sortie (/tmp par défaut)
+//
+// Chaque cas a une taille maximale raisonnable (par exemple, writeSVG produit une
+// balise par pixel) : les tailles supérieures sont ignorées pour ce cas.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "../head/Analyst.h"
+#include "../head/ContourSet.h"
+#include "../head/FixedImage.h"
+#include "../head/QuadImage.h"
+#include "../head/RasterWriter.h"
+#include "../head/TerrainGenerator.h"
+#include "../head/ZoneTracker.h"
+#include "../head/FireSimulator.h"
+
+using namespace std;
+
+// Simulateur à propagation locale, dont les étapes peuvent être parallélisées.
+typedef BasicFireSimulator <FireRules <8, 3, ForestFuel, BernoulliSpread <60>>> LocalFireSimulator;
+
+// Options de la ligne de commande.
+struct Options {
+
+  int minSize = 64;
+  int maxSize = 16384;
+  int reps = 7;
+  int warmup = 1;
+  string filter;
+  string json = "bench.json";
+  string baseline;
+  double threshold = 10.0;
+  string tmp = "/tmp";
+};
+
+// Résultat des mesures d'un cas pour une taille d'image.
+struct Result {
+
+  string name;
+  int size;
+  int reps;
+  double medianMs, p95Ms, minMs, meanMs;
+};
+
+// Un cas de test : prepare(size) est appelé hors mesure avant chaque exécution, run() est mesuré.
+struct Case {
+
+  string name;
+  int maxSize;
+  function <void(int)> prepare;
+  function <void()> run;
+};
+
+// Générateur pseudo-aléatoire déterministe, pour que les images soient identiques d'une version à l'autre.
+static unsigned nextRandom(unsigned& state) {
+
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Image de forêt parsemée de rectangles d'eau, de ville et de cendres, proche d'une vraie carte :
+// quelques centaines de zones plutôt qu'un pixel par zone.
+static Image makeWorkload(int size, unsigned seed) {
+
+  Image img(size, size);
+  img.fill(Color::Green);
+
+  int nbRects = 64 + size / 4;
+
+  for (int r = 0; r < nbRects; ++r) {
+
+    int h = 1 + nextRandom(seed) % max(1, size / 16);
+    int w = 1 + nextRandom(seed) % max(1, size / 16);
+    int i = nextRandom(seed) % (size - h + 1);
+    int j = nextRandom(seed) % (size - w + 1);
+
+    Color c = Color::makeColor(nextRandom(seed) % 4); // Black, White, Red ou Blue.
+
+    img.fillRectangle(i, j, i + h - 1, j + w - 1, c);
+  }
+
+  return img;
+}
+
+static double percentile(const vector <double>& sorted, double p) {
+
+  // Rang le plus proche : la plus petite mesure dont au moins p% des mesures sont inférieures ou égales.
+  size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+
+  return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+static Result measure(const Case& c, int size, const Options& opt) {
+
+  for (int w = 0; w < opt.warmup; ++w) {
+
+    c.prepare(size);
+    c.run();
+  }
+
+  vector <double> times;
+
+  for (int r = 0; r < opt.reps; ++r) {
+
+    c.prepare(size);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    c.run();
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    times.push_back(chrono::duration<double, milli>(end - start).count());
+  }
+
+  sort(times.begin(), times.end());
+
+  Result res;
+  res.name = c.name;
+  res.size = size;
+  res.reps = opt.reps;
+  res.medianMs = percentile(times, 50);
+  res.p95Ms = percentile(times, 95);
+  res.minMs = times.front();
+
+  double sum = 0;
+  for (double t : times) sum += t;
+  res.meanMs = sum / times.size();
+
+  return res;
+}
+
+static void writeJSON(const string& filename, const vector <Result>& results, const Options& opt) {
+
+  ofstream file(filename);
+
+  if (!file) throw runtime_error("error open file (write JSON)");
+
+  // Une ligne par résultat, ce qui permet aussi de relire le fichier simplement (voir readBaseline).
+  file << "{\n  \"reps\": " << opt.reps << ",\n  \"warmup\": " << opt.warmup << ",\n  \"results\": [\n";
+
+  for (size_t r = 0; r < results.size(); ++r) {
+
+    const Result& res = results[r];
+
+    file << "    {\"name\": \"" << res.name << "\", \"width\": " << res.size << ", \"height\": " << res.size
+         << ", \"reps\": " << res.reps << ", \"median_ms\": " << res.medianMs << ", \"p95_ms\": " << res.p95Ms
+         << ", \"min_ms\": " << res.minMs << ", \"mean_ms\": " << res.meanMs << "}"
+         << (r + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  file << "  ]\n}\n";
+}
+
+// Relit les médianes d'un fichier produit par writeJSON, indexées par "nom@taille".
+static map <string, double> readBaseline(const string& filename) {
+
+  ifstream file(filename);
+
+  if (!file) throw runtime_error("error open file (read baseline)");
+
+  map <string, double> medians;
+  string line;
+
+  while (getline(file, line)) {
+
+    char name[128];
+    int size;
+    double median;
+
+    if (sscanf(line.c_str(), " {\"name\": \"%127[^\"]\", \"width\": %d, \"height\": %*d, \"reps\": %*d, \"median_ms\": %lf",
+               name, &size, &median) == 3) {
+
+      medians[string(name) + "@" + to_string(size)] = median;
+    }
+  }
+
+  return medians;
+}
+
+static Options parseOptions(int argc, char** argv) {
+
+  Options opt;
+
+  for (int a = 1; a < argc; ++a) {
+
+    string arg = argv[a];
+
+    if (a + 1 >= argc) throw runtime_error("missing value for option " + arg);
+
+    string value = argv[++a];
+
+    if (arg == "--min-size") opt.minSize = stoi(value);
+    else if (arg == "--max-size") opt.maxSize = stoi(value);
+    else if (arg == "--reps") opt.reps = max(1, stoi(value));
+    else if (arg == "--warmup") opt.warmup = max(0, stoi(value));
+    else if (arg == "--filter") opt.filter = value;
+    else if (arg == "--json") opt.json = value;
+    else if (arg == "--baseline") opt.baseline = value;
+    else if (arg == "--threshold") opt.threshold = stod(value);
+    else if (arg == "--tmp") opt.tmp = value;
+    else throw runtime_error("unknown option " + arg);
+  }
+
+  return opt;
+}
+
+int main(int argc, char** argv) {
+
+  try {
+
+    Options opt = parseOptions(argc, argv);
+
+    // État partagé par les cas : préparé hors mesure par prepare().
+    unique_ptr <Image> img;
+    unique_ptr <Image> other;
+    unique_ptr <Analyst> analyst;
+    unique_ptr <FireSimulator> simulator;
+    unique_ptr <LocalFireSimulator> localSimulator;
+    unique_ptr <ZoneTracker> tracker;
+    unique_ptr <QuadImage> quad;
+    vector <char> arenaBuffer;
+    unique_ptr <pmr::monotonic_buffer_resource> arena;
+    string ioName = opt.tmp + "/aip_bench";
+    volatile long long sink = 0; // Empêche le compilateur de supprimer les calculs mesurés.
+
+    // Prépare l'image de travail de la taille demandée, réutilisée tant que la taille ne change pas.
+    auto workload = [&](int size) {
+
+      if (!img || img->getWidth() != size) {
+
+        analyst.reset();
+        tracker.reset();
+        quad.reset();
+        simulator.reset();
+        localSimulator.reset();
+        other.reset();
+        img.reset(new Image(makeWorkload(size, 42)));
+      }
+    };
+
+    // Côté de l'image de travail courante.
+    auto size0 = [&]() { return img->getWidth(); };
+
+    const int simSteps = 20;
+
+    vector <Case> cases = {
+
+      { "Image::readAIP", 4096,
+        [&](int size) { workload(size); img->writeAIP(ioName); },
+        [&]() { Image r = Image::readAIP(ioName); sink += r.getWidth(); } },
+
+      { "Image::writeAIP", 4096,
+        [&](int size) { workload(size); },
+        [&]() { img->writeAIP(ioName); } },
+
+      { "Image::writeSVG", 512,
+        [&](int size) { workload(size); },
+        [&]() { img->writeSVG(ioName, 10); } },
+
+      // Même agrandissement que writeSVG : chaque pixel devient un carré de 10x10.
+      { "RasterWriter::writePNG", 2048,
+        [&](int size) { workload(size); },
+        [&]() { RasterWriter(10).writePNG(*img, ioName); } },
+
+      { "RasterWriter::writePPM", 2048,
+        [&](int size) { workload(size); },
+        [&]() { RasterWriter(10).writePPM(*img, ioName); } },
+
+      { "Image::copy", 16384,
+        [&](int size) { workload(size); },
+        [&]() { Image c(*img); sink += c.getHeight(); } },
+
+      { "Image::operator==", 16384,
+        [&](int size) { workload(size); if (!other) other.reset(new Image(*img)); },
+        [&]() { sink += (*img == *other); } },
+
+      { "makeTerrainImage", 16384,
+        [&](int size) { workload(size); },
+        [&]() { Image t = makeTerrainImage(size0(), size0()); sink += t.getWidth(); } },
+
+      { "Analyst::nbPixelsOfColor", 16384,
+        [&](int size) { workload(size); },
+        [&]() { Analyst a(*img); sink += a.nbPixelsOfColor(Color::Green); } },
+
+      { "Analyst::nbZones", 2048,
+        [&](int size) { workload(size); },
+        [&]() { Analyst a(*img); sink += a.nbZones(); } },
+
+      // Une arène préparée une fois, vidée après chaque analyse : plus d'allocation en régime établi.
+      { "Analyst::nbZones (arena)", 1024,
+        [&](int size) {
+          workload(size);
+          arenaBuffer.assign(80 * static_cast<size_t>(size) * size, 0);
+          arena.reset(new pmr::monotonic_buffer_resource(arenaBuffer.data(), arenaBuffer.size()));
+        },
+        [&]() {
+          { Analyst a(*img, false, 4, arena.get()); sink += a.nbZones(); }
+          arena->release();
+        } },
+
+      { "Analyst::zoneOfPixel", 4096,
+        [&](int size) { workload(size); },
+        [&]() { Analyst a(*img); sink += a.zoneOfPixel(0, 0).size(); } },
+
+      { "Analyst::belongToTheSameZone", 2048,
+        [&](int size) { workload(size); if (!analyst) { analyst.reset(new Analyst(*img)); analyst->nbZones(); } },
+        [&]() {
+          int n = img->getWidth();
+          for (int k = 0; k < 100000; ++k) sink += analyst->belongToTheSameZone(k % n, (k * 7) % n, (k * 13) % n, (k * 3) % n);
+        } },
+
+      // Nettoyage d'une copie de l'image : toutes les petites zones blanches deviennent vertes, en un parcours.
+      { "Analyst::recolorZones", 1024,
+        [&](int size) { workload(size); },
+        [&]() {
+          Image c(*img);
+          Analyst a(c);
+          sink += a.recolorZones(c, [](int, Color col, int size) { return col == Color::White && size < 8 ? Color::Green : col; });
+        } },
+
+      // L'image est découpée en tuiles de 64x64 dont les zones sont numérotées sans allocation.
+      { "FixedImage <64,64> labelZones", 4096,
+        [&](int size) { workload(size); },
+        [&]() {
+          static FixedImage <64, 64> chip;
+          static int labels[64 * 64];
+          for (int i0 = 0; i0 + 64 <= size0(); i0 += 64) {
+            for (int j0 = 0; j0 + 64 <= size0(); j0 += 64) {
+              chip.copyFrom(*img, i0, j0);
+              sink += labelZones <4>(chip, labels);
+            }
+          }
+        } },
+
+      // Les mêmes zones, comptées sur les feuilles de l'arbre quaternaire.
+      { "QuadImage::nbZones", 16384,
+        [&](int size) { workload(size); if (!quad) quad.reset(new QuadImage(*img)); },
+        [&]() { sink += quad->nbZones(); } },
+
+      // Contours des zones de forêt, à partir d'une analyse déjà construite.
+      { "ContourSet (green)", 2048,
+        [&](int size) { workload(size); if (!analyst) { analyst.reset(new Analyst(*img)); analyst->nbZones(); } },
+        [&]() { ContourSet c(analyst->getResult(), Color::Green); sink += c.nbPoints(); } },
+
+      // Un carré de 32x32 pixels change de couleur, puis reprend la sienne : deux mises à jour.
+      { "ZoneTracker::update x2", 4096,
+        [&](int size) {
+          workload(size);
+          tracker.reset(new ZoneTracker(*img));
+          other.reset(new Image(*img));
+          other->fillRectangle(size / 2 - 16, size / 2 - 16, size / 2 + 15, size / 2 + 15, Color::Red);
+        },
+        [&]() { sink += tracker->update(*other).changedPixels + tracker->update(*img).changedPixels; } },
+
+      { "FireSimulator::nextStage x20", 4096,
+        [&](int size) {
+          workload(size);
+          simulator.reset();
+          other.reset(new Image(size, size));
+          other->fill(Color::Green);
+          simulator.reset(new FireSimulator(*other, size / 2, size / 2));
+        },
+        [&]() { for (int s = 0; s < simSteps; ++s) simulator->nextStage(); sink += simulator->getTime(); } },
+
+      // Propagation locale depuis une grille de départs, découpée en bandes sur tous les cœurs.
+      { "LocalFireSim::nextStage x20", 4096,
+        [&](int size) {
+          workload(size);
+          localSimulator.reset();
+          other.reset(new Image(size, size));
+          other->fill(Color::Green);
+          vector <int> starts;
+          for (int i = 32; i < size; i += 64) for (int j = 32; j < size; j += 64) starts.push_back(i * size + j);
+          localSimulator.reset(new LocalFireSimulator(*other, starts, Ignition::AtPixels));
+          localSimulator->setSeed(42);
+          localSimulator->setThreadCount(0);
+        },
+        [&]() { for (int s = 0; s < simSteps; ++s) localSimulator->nextStage(); sink += localSimulator->getTime(); } },
+    };
+
+    vector <Result> results;
+
+    printf("%-32s %7s %12s %12s %12s\n", "case", "size", "median(ms)", "p95(ms)", "min(ms)");
+
+    for (const Case& c : cases) {
+
+      if (!opt.filter.empty() && c.name.find(opt.filter) == string::npos) continue;
+
+      for (int size = opt.minSize; size <= min(opt.maxSize, c.maxSize); size *= 2) {
+
+        Result res = measure(c, size, opt);
+        results.push_back(res);
+
+        printf("%-32s %7d %12.3f %12.3f %12.3f\n", res.name.c_str(), res.size, res.medianMs, res.p95Ms, res.minMs);
+        fflush(stdout);
+      }
+
+      // Le cas suivant repart d'un état propre.
+      img.reset();
+    }
+
+    // Les fichiers temporaires d'entrée/sortie sont supprimés.
+    remove((ioName + ".aip").c_str());
+    remove((ioName + ".svg").c_str());
+    remove((ioName + ".png").c_str());
+    remove((ioName + ".ppm").c_str());
+
+    writeJSON(opt.json, results, opt);
+
+    cout << "Résultats enregistrés dans " << opt.json << endl;
+
+    if (!opt.baseline.empty()) {
+
+      map <string, double> base = readBaseline(opt.baseline);
+      int regressions = 0;
+
+      for (const Result& res : results) {
+
+        map <string, double>::const_iterator it = base.find(res.name + "@" + to_string(res.size));
+
+        if (it == base.end() || it->second <= 0) continue;
+
+        double change = 100.0 * (res.medianMs - it->second) / it->second;
+
+        if (change > opt.threshold) {
+
+          printf("REGRESSION %-32s %7d %+8.1f%% (%.3f ms -> %.3f ms)\n",
+                 res.name.c_str(), res.size, change, it->second, res.medianMs);
+          ++regressions;
+        }
+      }
+
+      cout << regressions << " régression(s) au-delà de " << opt.threshold << "%" << endl;
+
+      return regressions == 0 ? 0 : 2;
+    }
+  }
+  catch (const exception& e) {
+
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
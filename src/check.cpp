@@ -0,0 +1,428 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+// Vérifications de non-régression : les structures incrémentales ou compactes (ZoneTracker,
+// ContourSet, QuadImage, parcours par numéro de pixel) sont comparées, sur des images
+// aléatoires, à une analyse complète par Analyst ou à un calcul direct pixel par pixel.
+//
+// Utilisation : check.exe (ou "make check")
+//
+// Chaque écart est affiché sur la sortie d'erreur; le code de retour vaut 1 s'il y en a un.
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../head/Color.h"
+#include "../head/Image.h"
+#include "../head/AnalysisResult.h"
+#include "../head/Analyst.h"
+#include "../head/ContourSet.h"
+#include "../head/PixelGrid.h"
+#include "../head/QuadImage.h"
+#include "../head/ZoneTracker.h"
+
+using namespace std;
+
+// Nombre d'écarts relevés.
+static int failures = 0;
+
+// Relève un écart si ok est faux. Les premiers écarts seulement sont affichés.
+static void expect(bool ok, const string& what) {
+
+  if (ok) return;
+
+  if (++failures <= 20) cerr << "FAILED: " << what << endl;
+}
+
+// Générateur pseudo-aléatoire déterministe (celui de benchmark.cpp) : les images sont les mêmes à chaque exécution.
+static unsigned nextRandom(unsigned& state) {
+
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Repeint dans img nbRects rectangles aléatoires d'au plus maxSide pixels de côté.
+static void paintRectangles(Image& img, int nbRects, int maxSide, int nbColors, unsigned& seed) {
+
+  for (int r = 0; r < nbRects; ++r) {
+
+    int h = 1 + nextRandom(seed) % min(maxSide, img.getHeight());
+    int w = 1 + nextRandom(seed) % min(maxSide, img.getWidth());
+    int i = nextRandom(seed) % (img.getHeight() - h + 1);
+    int j = nextRandom(seed) % (img.getWidth() - w + 1);
+
+    img.fillRectangle(i, j, i + h - 1, j + w - 1, Color::makeColor(nextRandom(seed) % nbColors));
+  }
+}
+
+// Image de w*h pixels aléatoires parmi nbColors couleurs, avec des rectangles pour former de grandes zones.
+static Image randomImage(int w, int h, int nbColors, unsigned& seed) {
+
+  Image img(w, h);
+
+  img.forEachPixel([&](int, Color& col) { col = Color::makeColor(nextRandom(seed) % nbColors); });
+
+  paintRectangles(img, (w * h) / 64 + 1, max(w, h) / 3 + 1, nbColors, seed);
+
+  return img;
+}
+
+// Retourne vrai si les deux étiquetages a et b décrivent la même partition des pixels.
+static bool samePartition(const vector <int>& a, const vector <int>& b) {
+
+  if (a.size() != b.size()) return false;
+
+  map <int, int> aToB, bToA;
+
+  for (size_t k = 0; k < a.size(); ++k) {
+
+    if (aToB.emplace(a[k], b[k]).first->second != b[k]) return false;
+    if (bToA.emplace(b[k], a[k]).first->second != a[k]) return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Index de pixels : getPixel(k), forEachPixel, forEachInRect et changedPixels contre les coordonnées.
+static void checkPixelIndex() {
+
+  unsigned seed = 47;
+
+  for (int t = 0; t < 50; ++t) {
+
+    int w = 1 + nextRandom(seed) % 70, h = 1 + nextRandom(seed) % 70;
+
+    Image img = randomImage(w, h, Color::nbColors(), seed);
+    Image other(img);
+
+    paintRectangles(other, 3, 8, Color::nbColors(), seed);
+
+    for (int n = nextRandom(seed) % 10; n > 0; --n) {
+
+      other.setPixel(nextRandom(seed) % (w * h), Color::makeColor(nextRandom(seed) % Color::nbColors()));
+    }
+
+    string name = "pixel index " + to_string(w) + "x" + to_string(h);
+    bool ok = true;
+    vector <int> changed;
+
+    for (int i = 0; i < h; ++i) {
+
+      for (int j = 0; j < w; ++j) {
+
+        int k = img.toIndex(i, j);
+
+        ok = ok && k == i * w + j && img.toCoordinate(k) == make_pair(i, j) && img.getPixel(k) == img.getPixel(i, j);
+
+        if (img.getPixel(i, j) != other.getPixel(i, j)) changed.push_back(k);
+      }
+    }
+
+    expect(ok, name + ": toIndex/getPixel(k)");
+    expect(img.changedPixels(other) == changed, name + ": changedPixels");
+    expect((img == other) == changed.empty(), name + ": operator==");
+
+    int next = 0;
+
+    img.forEachPixel([&](int k, Color col) { ok = ok && k == next++ && col == img.getPixel(k); });
+
+    expect(ok && next == w * h, name + ": forEachPixel");
+
+    int i1 = nextRandom(seed) % h, i2 = i1 + nextRandom(seed) % (h - i1);
+    int j1 = nextRandom(seed) % w, j2 = j1 + nextRandom(seed) % (w - j1);
+    vector <int> inRect, expected;
+
+    img.forEachInRect(i1, j1, i2, j2, [&](int k, Color col) { ok = ok && col == img.getPixel(k); inRect.push_back(k); });
+
+    for (int i = i1; i <= i2; ++i) for (int j = j1; j <= j2; ++j) expected.push_back(i * w + j);
+
+    expect(ok && inRect == expected, name + ": forEachInRect");
+  }
+}
+
+// Étiquetage en place (labelZones) et analyse complète contre Analyst::zoneIndex.
+static void checkLabels() {
+
+  unsigned seed = 40;
+
+  for (int t = 0; t < 40; ++t) {
+
+    int w = 1 + nextRandom(seed) % 60, h = 1 + nextRandom(seed) % 60;
+    int connectivity = (t % 2) ? 8 : 4;
+
+    Image img = randomImage(w, h, 2 + t % 4, seed);
+    Analyst a(img, true, connectivity);
+    AnalysisResult result = a.getResult();
+
+    string name = "labels " + to_string(w) + "x" + to_string(h) + " connectivity " + to_string(connectivity);
+    vector <int> labels(w * h);
+    bool ok = true;
+
+    expect(labelZones(img, labels.data(), connectivity) == a.nbZones(), name + ": labelZones count");
+    expect(samePartition(labels, result.labels), name + ": labelZones partition");
+
+    for (int i = 0; i < h; ++i) for (int j = 0; j < w; ++j) ok = ok && a.zoneIndex(i, j) == result.labels[i * w + j];
+
+    expect(ok, name + ": zoneIndex");
+
+    for (int c = 0; c < Color::nbColors(); ++c) {
+
+      Color col = Color::makeColor(c);
+
+      expect(a.nbZonesOfColor(col) == result.zonesPerColor[c], name + ": zonesPerColor");
+      expect(a.nbPixelsOfColor(col) == result.pixelsPerColor[c], name + ": pixelsPerColor");
+    }
+
+    // recolorZones tient l'analyse à jour : elle doit répondre comme une analyse neuve de l'image repeinte.
+    Image repainted(img);
+    Analyst b(repainted, true, connectivity);
+
+    b.recolorZones(repainted, [&](int z, Color col, int size) {
+      return (size < 4 || z % 3 == 0) ? Color::makeColor((col.toInt() + 1) % 3) : col;
+    });
+
+    Analyst fresh(repainted, false, connectivity);
+
+    expect(b.nbZones() == fresh.nbZones(), name + ": recolorZones count");
+    expect(samePartition(b.getResult().labels, fresh.getResult().labels), name + ": recolorZones partition");
+
+    for (int c = 0; c < Color::nbColors(); ++c) {
+
+      Color col = Color::makeColor(c);
+
+      expect(b.nbZonesOfColor(col) == fresh.nbZonesOfColor(col), name + ": recolorZones zonesPerColor");
+      expect(b.nbPixelsOfColor(col) == fresh.nbPixelsOfColor(col), name + ": recolorZones pixelsPerColor");
+    }
+  }
+}
+
+// Suivi incrémental : après chaque image, les zones de ZoneTracker sont celles d'une analyse neuve.
+static void checkTracker() {
+
+  unsigned seed = 44;
+
+  for (int t = 0; t < 12; ++t) {
+
+    int w = 8 + nextRandom(seed) % 56, h = 8 + nextRandom(seed) % 56;
+    int connectivity = (t % 2) ? 8 : 4;
+    int nbColors = 2 + t % 3;
+
+    Image img = randomImage(w, h, nbColors, seed);
+    ZoneTracker tracker(img, connectivity);
+
+    string name = "tracker " + to_string(w) + "x" + to_string(h) + " connectivity " + to_string(connectivity);
+
+    for (int step = 0; step < 500; ++step) {
+
+      Image next(img);
+
+      // Petites retouches le plus souvent, parfois un grand rectangle qui coupe ou réunit des zones.
+      if (step % 25 == 0) paintRectangles(next, 1, max(w, h), nbColors, seed);
+      else paintRectangles(next, 1 + nextRandom(seed) % 3, 4, nbColors, seed);
+
+      for (int n = nextRandom(seed) % 4; n > 0; --n) {
+
+        next.setPixel(nextRandom(seed) % (w * h), Color::makeColor(nextRandom(seed) % nbColors));
+      }
+
+      vector <int> changed = img.changedPixels(next);
+      TrackingStep s = (step % 2) ? tracker.update(next, changed) : tracker.update(next);
+
+      img.forEachPixel([&](int k, Color& col) { col = next.getPixel(k); });
+
+      AnalysisResult result = Analyst(img, false, connectivity).getResult();
+      const vector <int>& ids = tracker.getLabels();
+      string at = name + " step " + to_string(step);
+      bool ok = true;
+
+      expect(s.changedPixels == static_cast<int>(changed.size()), at + ": changedPixels");
+      expect(tracker.nbZones() == result.nbZones(), at + ": nbZones");
+      expect(samePartition(ids, result.labels), at + ": partition");
+
+      for (int z = 0; z < result.nbZones(); ++z) {
+
+        int id = ids[result.zonePixels[result.zoneOffsets[z]]];
+
+        ok = ok && tracker.isAlive(id) && tracker.zoneColor(id) == result.zoneColors[z] && tracker.zoneArea(id) == result.zoneSize(z);
+      }
+
+      expect(ok, at + ": zone colour and area");
+
+      for (int id : s.deaths) expect(!tracker.isAlive(id) && tracker.zoneArea(id) == 0, at + ": dead zone");
+      for (int id : s.births) expect(tracker.isAlive(id), at + ": born zone");
+
+      if (failures > 0) return;
+    }
+  }
+}
+
+// Inverse dans inside les pixels à gauche de chaque bord vertical de ring : un pixel est à l'intérieur
+// d'un polygone si un nombre impair de bords se trouvent à sa droite (règle pair-impair du SVG).
+static void toggleInside(const ContourRing& ring, int w, vector <bool>& inside, bool& axisAligned) {
+
+  for (size_t n = 0; n < ring.size(); ++n) {
+
+    pair <int, int> p = ring[n], q = ring[(n + 1) % ring.size()];
+
+    axisAligned = axisAligned && (p.first == q.first) != (p.second == q.second);
+
+    if (p.first != q.first) continue;
+
+    for (int i = min(p.second, q.second); i < max(p.second, q.second); ++i) {
+
+      for (int j = 0; j < p.first && j < w; ++j) inside[i * w + j] = !inside[i * w + j];
+    }
+  }
+}
+
+// Contours : l'intérieur de chaque polygone est exactement l'ensemble des pixels de sa zone.
+static void checkContours() {
+
+  unsigned seed = 43;
+
+  for (int t = 0; t < 40; ++t) {
+
+    int w = 1 + nextRandom(seed) % 48, h = 1 + nextRandom(seed) % 48;
+    int connectivity = (t % 2) ? 8 : 4;
+    Color c = Color::makeColor(t % 3);
+
+    Image img = randomImage(w, h, 3, seed);
+    AnalysisResult result = Analyst(img, false, connectivity).getResult();
+    ContourSet contours(result, c);
+
+    string name = "contours " + to_string(w) + "x" + to_string(h) + " connectivity " + to_string(connectivity);
+    vector <bool> traced(result.nbZones(), false);
+
+    for (const ZonePolygon& polygon : contours.getPolygons()) {
+
+      int z = polygon.zone;
+
+      expect(z >= 0 && z < result.nbZones() && !traced[z], name + ": zone traced once");
+
+      if (z < 0 || z >= result.nbZones() || traced[z]) continue;
+
+      traced[z] = true;
+
+      vector <bool> inside(w * h, false);
+      bool axisAligned = true;
+
+      for (const ContourRing& ring : polygon.rings) toggleInside(ring, w, inside, axisAligned);
+
+      bool ok = true;
+
+      for (int k = 0; k < w * h; ++k) ok = ok && inside[k] == (result.labels[k] == z);
+
+      expect(polygon.color == c && result.zoneColors[z] == c, name + ": polygon colour");
+      expect(axisAligned, name + ": axis-aligned edges");
+      expect(ok, name + ": polygon interior");
+    }
+
+    for (int z = 0; z < result.nbZones(); ++z) {
+
+      expect(traced[z] == (result.zoneColors[z] == c), name + ": every zone of the colour traced");
+    }
+  }
+}
+
+// QuadImage : mêmes pixels, comptages et zones qu'une Image modifiée de la même façon.
+static void checkQuadImage() {
+
+  unsigned seed = 45;
+
+  for (int t = 0; t < 30; ++t) {
+
+    int w = 1 + nextRandom(seed) % 70, h = 1 + nextRandom(seed) % 70;
+    int nbColors = 2 + t % 4;
+
+    Image img = randomImage(w, h, nbColors, seed);
+    QuadImage quad(img);
+
+    string name = "quadimage " + to_string(w) + "x" + to_string(h);
+
+    for (int step = 0; step < 20; ++step) {
+
+      int i1 = nextRandom(seed) % h, i2 = i1 + nextRandom(seed) % (h - i1);
+      int j1 = nextRandom(seed) % w, j2 = j1 + nextRandom(seed) % (w - j1);
+      Color col = Color::makeColor(nextRandom(seed) % nbColors);
+
+      if (step % 3 == 0) {
+
+        img.setPixel(i1, j1, col);
+        quad.setPixel(i1, j1, col);
+      }
+      else {
+
+        img.fillRectangle(i1, j1, i2, j2, col);
+        quad.fillRectangle(i1, j1, i2, j2, col);
+      }
+
+      string at = name + " step " + to_string(step);
+      bool ok = true;
+
+      for (int i = 0; i < h; ++i) for (int j = 0; j < w; ++j) ok = ok && quad.getPixel(i, j) == img.getPixel(i, j);
+
+      expect(ok, at + ": getPixel");
+      expect(quad.toImage() == img, at + ": toImage");
+
+      for (int connectivity : { 4, 8 }) {
+
+        Analyst a(img, false, connectivity);
+        vector <int> zones = quad.zonesPerColor(connectivity);
+
+        expect(quad.nbZones(connectivity) == a.nbZones(), at + ": nbZones " + to_string(connectivity));
+
+        for (int c = 0; c < Color::nbColors(); ++c) {
+
+          Color cc = Color::makeColor(c);
+
+          expect(zones[c] == a.nbZonesOfColor(cc), at + ": zonesPerColor " + to_string(connectivity));
+          expect(quad.nbPixelsOfColor(cc) == a.nbPixelsOfColor(cc), at + ": nbPixelsOfColor");
+        }
+      }
+    }
+
+    // Une image repeinte d'une seule couleur ne forme plus qu'une zone.
+    quad.fill(Color::Green);
+
+    expect(quad.nbZones() == 1 && quad.nbPixelsOfColor(Color::Green) == w * h, name + ": fill");
+  }
+}
+
+int main() {
+
+  struct Check { const char* name; void (*run)(); };
+
+  const Check checks[] = {
+    { "pixel index", checkPixelIndex },
+    { "labels", checkLabels },
+    { "tracker", checkTracker },
+    { "contours", checkContours },
+    { "quadimage", checkQuadImage },
+  };
+
+  for (const Check& check : checks) {
+
+    int before = failures;
+
+    check.run();
+
+    cout << (failures == before ? "ok     " : "FAILED ") << check.name << endl;
+  }
+
+  if (failures > 0) {
+
+    cerr << failures << " check(s) failed" << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -10,6 +10,7 @@
 #include <ctime>
 #include <sstream>
 #include <iostream>
+#include "../head/Metrics.h"
 #include "../head/FireSimulator.h"
 
 using namespace std;
@@ -37,22 +38,45 @@ int main(void) {
   * du premier pixel de l'image. */
   FireSimulator f(readImg, 0, 0);
 
-  /* Simule 7 étapes d'un incendie, crée 8 fichiers image'i'.aip
-  * et retourne les 8 images correspondantes. */
-  vector <Image> tab = f.runSimulator(7);
+  /* Les fichiers sont écrits en arrière-plan par deux fils,
+  * pendant que la simulation continue. */
+  FrameWriter writer(2);
+
+  /* Simule 7 étapes d'un incendie et crée 8 fichiers image'i'.aip, comme
+  * runSimulator, en terminant à chaque étape la ligne du relevé des mesures. */
+  vector <Image> tab;
+
+  tab.push_back(f.getImage());
+  writer.writeAIP(tab[0], "images/image" + to_string(f.getTime()));
+
+  for (int t = 1; t <= 7; ++t) {
+
+    f.nextStage();
+    AIP_STEP();
+
+    tab.push_back(f.getImage());
+    writer.writeAIP(tab[t], "images/image" + to_string(f.getTime()));
+  }
 
 
   /* La suite transforme en fichiers .svg les images de la simulation recueillies. */
   
   int i = 0;
 
-  for (Image sim : tab) {
+  for (const Image& sim : tab) {
 
     string name = ("svg/image" + to_string(i));
-    sim.writeSVG(name, 20);
+    writer.writeSVG(sim, name, 20);
     ++i;
   }
 
+  /* Attend la fin de l'écriture des fichiers. */
+  writer.flush();
+
+  /* Avec "make INSTRUMENT=1", les mesures de chaque étape sont écrites
+  * dans metrics.csv et metrics.json. */
+  AIP_EXPORT("metrics");
+
   cout << "Fin du programme !\nVous retrouverez les images de la simulation dans le dossier svg.\n";
 
   return 0;
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Ce fichier appartient au projet Aerial Image Project (AIP).
+///
+/// Copyright (c) ...
+///
+/// Les sources de AIP sont distribuées sans aucune garantie.
+////////////////////////////////////////////////////////////////////////////////
+
+// Serveur de commandes : les images chargées, leurs analyses et les simulations restent
+// en mémoire d'une commande à l'autre (voir CommandServer.h pour les commandes).
+//
+// Utilisation : server.exe [options]
+//   --socket CHEMIN   écoute sur une socket locale (Unix), une connexion par fil
+//                     (sans cette option, les commandes sont lues sur l'entrée standard
+//                     et les réponses écrites sur la sortie standard)
+//   --cache N         nombre d'analyses gardées en mémoire par voisinage (64 par défaut)
+//
+// Exemple :
+//   echo '{"cmd": "load", "session": "a", "file": "images/image0"}' | ./server.exe
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../head/CommandServer.h"
+
+using namespace std;
+
+// Options de la ligne de commande.
+struct Options {
+
+  string socket;
+  int cacheCapacity = 64;
+};
+
+static Options parseOptions(int argc, char** argv) {
+
+  Options opt;
+
+  for (int a = 1; a < argc; ++a) {
+
+    string arg = argv[a];
+
+    if (a + 1 >= argc) throw runtime_error("missing value for option " + arg);
+
+    string value = argv[++a];
+
+    if (arg == "--socket") opt.socket = value;
+    else if (arg == "--cache") opt.cacheCapacity = stoi(value);
+    else throw runtime_error("unknown option " + arg);
+  }
+
+  if (opt.cacheCapacity < 1) throw runtime_error("cache must hold at least one analysis");
+
+  return opt;
+}
+
+int main(int argc, char** argv) {
+
+  try {
+
+    Options opt = parseOptions(argc, argv);
+
+    CommandServer server(opt.cacheCapacity);
+
+    if (opt.socket.empty()) server.serve(cin, cout);
+
+    else {
+
+      cerr << "listening on " << opt.socket << endl;
+
+      server.serveSocket(opt.socket);
+    }
+
+    return 0;
+  }
+  catch (const exception& e) {
+
+    cerr << e.what() << endl;
+    return 1;
+  }
+}